@@ -1,6 +1,8 @@
 #pragma once
 
+#include "app/common/Clock.hpp"
 #include "app/common/EventLoop.hpp"
+#include "app/common/TickTimer.hpp"
 
 #include "app/blinker/Blinker.hpp"
 #include "app/encoders/Encoder0.hpp"
@@ -35,6 +37,9 @@ private:
 
 	// commons
 	common::EventLoop _eventLoop;
+	common::Clock _clock;
+	common::TickDevice _tickDevice;
+	common::TickTimer _tickTimer;
 
 	// modules
 	blinker::Blinker _blinker;
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "device/Clock.hpp"
+
+namespace app {
+namespace common {
+
+//! Fine, application-wide time base, counting CPU clock cycles.
+//! Free-running 32-bit timer, so it wraps around every ~53 seconds
+using Clock = device::Clock<TIMER1_BASE, SYSCTL_PERIPH_TIMER1>;
+
+} // namespace common
+} // namespace app
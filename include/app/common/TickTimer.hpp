@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "embxx/util/StaticFunction.h"
+
+#include "device/SysTick.hpp"
+
+#include "driver/TickTimer.hpp"
+
+#include "app/common/EventLoop.hpp"
+
+namespace app {
+namespace common {
+
+//! Period of the coarse, application-wide time base
+constexpr static auto TickPeriodMs = 10U;
+
+//! Maximum number of modules subscribed to the time base
+constexpr static auto TickMaxHandlers = 4U;
+
+using TickDevice = device::SysTick<TickPeriodMs>;
+using TickHandler =
+	embxx::util::StaticFunction<void(std::uint32_t), 1 * sizeof(void*)>;
+using TickTimer =
+	driver::TickTimer<EventLoop, TickDevice, TickHandler, TickMaxHandlers>;
+
+} // namespace common
+} // namespace app
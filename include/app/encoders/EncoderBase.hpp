@@ -29,6 +29,9 @@ class EncoderBase
 public:
 	using Position = component::Position;
 
+	//! Width of the position in bits
+	constexpr static std::size_t Resolution = 13;
+
 	//! Constructor
 	EncoderBase(EventLoop& eventLoop)
 		:	_ssiMasterDevice(DefaultBitRate, DefaultFrameWidth),
@@ -54,6 +57,23 @@ public:
 			[this](auto errorCode) { positionRead(errorCode); });
 	}
 
+	//! Captures current encoder positions asynchronously. May be called from
+	//!  interrupt context, handler is invoked from the SSI interrupt
+	template<typename THandler>
+	void asyncCaptureInputsInterruptCtx(Position* destPosition,
+		THandler&& handler)
+	{
+		// Module should not be busy and have "active status"
+		assert(!isBusy());
+
+		// Store provided handler
+		_inputsCapturedHandler = std::forward<THandler>(handler);
+
+		// Begin asynchronous read of position
+		_ssiEncoder.asyncReadPositionInterruptCtx(destPosition,
+			[this](auto errorCode) { positionRead(errorCode); });
+	}
+
 	//! Captures current encoder position in blocking way
 	void captureInputs(Position& position, ErrorCode& errorCode)
 	{
@@ -87,7 +107,7 @@ private:
 	// Default SSI settings for encoders.
 	constexpr static auto DefaultBitRate = 1250000;
 	constexpr static auto DefaultFrameWidth = 13;
-	constexpr static auto DefaultResolution = 13;
+	constexpr static auto DefaultResolution = Resolution;
 
 	void positionRead(ErrorCode errorCode)
 	{
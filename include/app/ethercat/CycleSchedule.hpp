@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace app {
+namespace ethercat {
+
+//! Work done at a fixed point of each SYNC cycle
+enum class CycleTask
+{
+	CaptureInputs, //< Starts capture of both encoders
+	WriteProcessData, //< Publishes captured inputs and sends them to the module
+	ServiceMessages //< Runs the driver for queued messages
+};
+
+//! Single entry of a cycle schedule
+struct CycleSlot
+{
+	std::int32_t offsetUs; //< From SYNC, negative ahead of it
+	std::uint32_t budgetUs; //< Worst case, until the task is done
+	CycleTask task;
+
+	constexpr std::int32_t getEndUs() const
+	{
+		return offsetUs + static_cast<std::int32_t>(budgetUs);
+	}
+};
+
+//! Checks, that slots are in order and none starts before the previous one
+//!  is done
+template<std::size_t TSize>
+constexpr bool isScheduleOrdered(const std::array<CycleSlot, TSize>& schedule)
+{
+	for(std::size_t i = 1; i < TSize; ++i)
+	{
+		if(schedule[i].offsetUs < schedule[i - 1].getEndUs())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//! Returns time from the start of the first slot to the end of the last one
+template<std::size_t TSize>
+constexpr std::uint32_t getScheduleSpanUs(
+	const std::array<CycleSlot, TSize>& schedule)
+{
+	static_assert(TSize > 0, "Schedule is empty");
+	return static_cast<std::uint32_t>(
+		schedule.back().getEndUs() - schedule.front().offsetUs);
+}
+
+//! Returns number of slots running given task
+template<std::size_t TSize>
+constexpr std::size_t countScheduleSlots(
+	const std::array<CycleSlot, TSize>& schedule, CycleTask task)
+{
+	std::size_t count = 0;
+	for(const auto& slot : schedule)
+	{
+		if(slot.task == task)
+		{
+			++count;
+		}
+	}
+
+	return count;
+}
+
+//! Returns the first slot running given task. It has to be there
+template<std::size_t TSize>
+constexpr const CycleSlot& findScheduleSlot(
+	const std::array<CycleSlot, TSize>& schedule, CycleTask task)
+{
+	for(const auto& slot : schedule)
+	{
+		if(slot.task == task)
+		{
+			return slot;
+		}
+	}
+
+	return schedule.front();
+}
+
+} // namespace ethercat
+} // namespace app
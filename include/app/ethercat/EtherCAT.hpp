@@ -1,26 +1,42 @@
 #pragma once
 
+#include "app/common/Clock.hpp"
 #include "app/common/EventLoop.hpp"
+#include "app/common/TickTimer.hpp"
 
 #include "embxx/util/StaticFunction.h"
 #include "embxx/error/ErrorCode.h"
 
+#include "device/DeadlineTimer.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
 #include "app/encoders/Encoder0.hpp"
 #include "app/encoders/Encoder1.hpp"
 
+#include "app/ethercat/CycleSchedule.hpp"
+#include "app/ethercat/SyncMonitor.hpp"
+#include "app/ethercat/SyncPll.hpp"
+
 #include "app/ethercat/abcc_appl/appl_abcc_handler.h"
 #include "app/ethercat/abcc_abp/abp.h"
+#include "app/ethercat/abcc_drv/abcc.h"
 
 extern "C" void ABCC_CbfSyncIsr();
 extern "C" void ABCC_CbfEvent(UINT16);
+extern "C" void ABCC_CbfSpiTransferDone();
 extern "C" void ABCC_CbfUserInitReq();
 extern "C" void ABCC_CbfAnbStateChanged(ABP_AnbStateType);
+extern "C" void ABCC_CbfWdTimeout();
+extern "C" void ABCC_CbfSpiSchedEvent(ABCC_SpiSchedEventType);
+extern "C" void ABCC_CbfNewReadPd(void*);
+extern "C" BOOL ABCC_CbfUpdateWriteProcessData(void*);
 extern "C" void setEncoder0Settings(const struct AD_AdiEntry* psAdiEntry,
 	UINT8 bNumElements, UINT8 bStartIndex);
-extern "C" void getEncoder0Inputs(const struct AD_AdiEntry* adiEntry,
-	UINT8 numElements, UINT8 startIndex);
-extern "C" void getEncoder1Inputs(const struct AD_AdiEntry* adiEntry,
-	UINT8 numElements, UINT8 startIndex);
 
 namespace app {
 namespace ethercat {
@@ -31,7 +47,54 @@ class EtherCAT
 public:
 	using ErrorCode = embxx::error::ErrorCode;
 
+	//! Upper bound for the module to signal readiness after its reset is
+	//!  released, the module's documented startup time. Waiting itself ends
+	//!  as soon as the module does it. A shorter one would keep resetting
+	//!  a slowly booting module by recovery
+	constexpr static std::uint32_t StartupTimeoutMs = ABCC_CFG_STARTUP_TIME_MS;
+
+	//! Module is held in reset for this long on the first recovery attempt.
+	//!  Each next consecutive attempt waits twice as long, up to the maximum
+	constexpr static std::uint32_t RecoveryMinDelayMs = 10;
+	constexpr static std::uint32_t RecoveryMaxDelayMs = 1000;
+
+	//! Input capture period in free-run mode. Paced by the tick timer, so it
+	//!  has to be a multiple of its period
+	constexpr static std::uint32_t FreeRunCycleMs = common::TickPeriodMs;
+	static_assert(FreeRunCycleMs % common::TickPeriodMs == 0,
+		"Free-run cycle is not a multiple of the tick period");
+
+	//! Work of a SYNC cycle, run from a timer once the PLL is locked to SYNC.
+	//!  Offsets are from the predicted edge, so inputs are captured and sent
+	//!  to the module by then. Validated against the sync object timing
+	constexpr static std::array<CycleSlot, 3> CycleSchedule{{
+		{ -40, 15, CycleTask::CaptureInputs }, // Both SSI frames, ~11 us
+		{ -20, 20, CycleTask::WriteProcessData }, // Until the PD frame starts
+		{ 20, 40, CycleTask::ServiceMessages } // After the PD frame is done
+	}};
+
+	//! Window of SYNC period statistics. Both they and latency histograms are
+	//!  published in their ADIs at its end
+	constexpr static std::uint32_t DiagnosticsWindowMs = 1000;
+
+	//! Bins of cycle latency log2 histograms, the last one collects any
+	//!  latency from 2^(LatencyHistogramBins - 2) us up
+	constexpr static std::size_t LatencyHistogramBins = 16;
+
+	//! Sync object timing is the measured worst case plus this share of it,
+	//!  so a slightly longer cycle does not break the schedule of the master
+	constexpr static std::uint32_t TimingMarginPercent = 25;
+
+	//! Captures timed during user init, before the master can read the sync
+	//!  object timing
+	constexpr static std::uint32_t TimingCalibrationCaptures = 32;
+
+	//! Interval of SPI frame scheduling statistics reports
+	constexpr static std::uint32_t SchedStatsReportMs = 10000;
+
 	EtherCAT(common::EventLoop& eventLoop,
+		common::Clock& clock,
+		common::TickTimer& tickTimer,
 		encoders::Encoder0& encoder0,
 		encoders::Encoder1& encoder1);
 
@@ -42,11 +105,14 @@ public:
 private:
 	friend void ::ABCC_CbfSyncIsr();
 	friend void ::ABCC_CbfEvent(UINT16);
+	friend void ::ABCC_CbfSpiTransferDone();
 	friend void ::ABCC_CbfUserInitReq();
 	friend void ::ABCC_CbfAnbStateChanged(ABP_AnbStateType);
+	friend void ::ABCC_CbfWdTimeout();
+	friend void ::ABCC_CbfSpiSchedEvent(ABCC_SpiSchedEventType);
+	friend void ::ABCC_CbfNewReadPd(void*);
+	friend BOOL ::ABCC_CbfUpdateWriteProcessData(void*);
 	friend void ::setEncoder0Settings(const struct AD_AdiEntry *, UINT8, UINT8);
-	friend void ::getEncoder0Inputs(const struct AD_AdiEntry *, UINT8, UINT8);
-	friend void ::getEncoder1Inputs(const struct AD_AdiEntry *, UINT8, UINT8);
 
 	enum class State
 	{
@@ -54,31 +120,351 @@ private:
 		DriverInit,
 		WaitForComm,
 		Run,
+		Recovery,
 		Error
 	};
 
+	//! Event, on which inputs are captured and sent to the module
+	enum class SyncMode
+	{
+		FreeRun, //< Local timer, not related to the bus cycle
+		SmSynchronous, //< New read process data (SM2 event)
+		DcSynchronous, //< SYNC0 signal
+		Count
+	};
+
+	constexpr static auto SyncModeCount =
+		static_cast<std::size_t>(SyncMode::Count);
+
+	//! Milestones on the way to PROCESS_ACTIVE, timestamped for boot report
+	enum class BootPhase
+	{
+		Start,
+		HardwareReady,
+		ResetReleased,
+		CommReady,
+		UserInit,
+		NetworkInit,
+		WaitProcess,
+		ProcessActive,
+		Count
+	};
+
+	constexpr static auto BootPhaseCount =
+		static_cast<std::size_t>(BootPhase::Count);
+
+	//! Points of a single cycle, from its start to the PD frame transfer end,
+	//!  timestamped for latency histograms. Scheduled cycles start at their
+	//!  capture slot, ahead of SYNC, see SyncOffsetStats for timing against it
+	enum class CyclePhase
+	{
+		Start, //< SYNC ISR entry, capture slot, SM event or free-run tick
+		CaptureStart,
+		CaptureEnd,
+		PdCopy,
+		SpiStart,
+		SpiEnd,
+		Count
+	};
+
+	constexpr static auto CyclePhaseCount =
+		static_cast<std::size_t>(CyclePhase::Count);
+
+	//! Log2 histogram of latencies. Bin 0 counts latencies below 1 us, bin i
+	//!  the ones in [2^(i-1), 2^i) us, and the last one all longer ones.
+	//!  Extremes and the last latency are kept as well
+	struct LatencyHistogram
+	{
+		std::array<std::uint32_t, LatencyHistogramBins> counts{};
+		std::uint32_t count = 0; //< Of all bins
+		std::uint32_t minUs = 0; //< Valid, once anything was added
+		std::uint32_t maxUs = 0;
+		std::uint32_t lastUs = 0;
+
+		void add(std::uint32_t latencyUs);
+
+		void print(const char* name) const;
+	};
+
+	//! Latency statistics, collected over a single report interval
+	struct LatencyStats
+	{
+		std::uint32_t count = 0;
+		std::uint32_t minUs = 0;
+		std::uint32_t maxUs = 0;
+		std::uint32_t sumUs = 0;
+
+		void add(std::uint32_t latencyUs);
+
+		//! Prints min/avg/max, if anything was collected
+		void print(const char* name) const;
+	};
+
+	//! Offsets from the SYNC of the cycle, collected over a single report
+	//!  interval. Negative ones are ahead of SYNC, e.g. of a scheduled capture
+	struct SyncOffsetStats
+	{
+		std::uint32_t count = 0;
+		std::int32_t minUs = 0;
+		std::int32_t maxUs = 0;
+		std::int32_t sumUs = 0;
+
+		void add(std::int32_t offsetUs);
+
+		//! Prints min/avg/max, if anything was collected
+		void print(const char* name) const;
+	};
+
+	//! Signed clock duration, so times ahead of SYNC do not wrap around
+	using SyncOffset = std::chrono::duration<std::int32_t,
+		common::Clock::period>;
+
+	using ScheduleTimerDevice =
+		device::DeadlineTimer<TIMER2_BASE, SYSCTL_PERIPH_TIMER2, INT_TIMER2A>;
+
+	//! Ways a cycle misses its deadline, each counted separately. Deadline of
+	//!  a stage is the end of its cycle, unless stated otherwise
+	enum class Overrun
+	{
+		CaptureSkipped, //< Previous capture was still in progress
+		CaptureLate, //< Over the capture slot budget, when scheduled
+		ProcessLate,
+		PdLate, //< PD frame with the inputs started, a cycle from its SYNC
+		SlotMissed, //< Cycle schedule was late for a slot
+		Count
+	};
+
+	constexpr static auto OverrunCount =
+		static_cast<std::size_t>(Overrun::Count);
+
+	//! Single encoder capture, handed over from interrupt to event loop
+	struct EncoderCapture
+	{
+		encoders::Encoder0::Position position = 0; //< Last good one
+		bool error = false;
+	};
+
 	void setupABCCHardware();
 
 	void initDriver();
 
 	void waitForCommunication();
 
+	//! Checks, whether module became ready or startup timeout has expired
+	void checkCommunication();
+
 	void run();
 
+	//! Resets the module and schedules restart of the driver, after a delay
+	//!  growing with the number of consecutive attempts
+	void startRecovery();
+
+	//! Restarts the driver, once the recovery delay has elapsed
+	void checkRecovery(std::uint32_t elapsedMs);
+
+	//! Updates and prints recovery metrics, once the module answers again
+	void finishRecovery();
+
+	//! Schedules ABCC_RunDriver() call from event loop context
+	void scheduleDriverRun();
+
+	//! Schedules ABCC_RunDriver() call from interrupt context
+	void scheduleDriverRunInterruptCtx();
+
+	void runDriver();
+
+	//! Advances ABCC driver timers, called from event loop context
+	void handleTick(std::uint32_t elapsedMs);
+
+	//! Timestamps SYNC and starts the capture. Anything else is deferred
 	void handleSyncISR();
 
-	void captureInputs();
+	//! Non time critical part of SYNC handling, run in the event loop
+	void handleSyncDeferred();
+
+	//! Starts the cycle schedule against the next SYNC predicted by the PLL,
+	//!  called from the SYNC interrupt
+	void startCycleSchedule();
+
+	//! Arms the timer for the next slot, going on with the next cycle after
+	//!  the last one. Schedule stops, when it is late for the slot, or the
+	//!  PLL is not locked anymore
+	void armCycleSlot();
+
+	//! Stops the cycle schedule, called from interrupt context
+	void stopCycleSchedule();
+
+	//! Runs the task of the current slot, called from the timer interrupt
+	void handleCycleSlot();
+
+	//! Starts capture of both encoders, from interrupt or event loop context.
+	//!  Skipped, if the previous one is still in progress, what is returned
+	//!  as false. Scheduled capture is processed only once the write process
+	//!  data slot comes
+	bool captureInputs(common::Clock::time_point cycleStartTime, bool scheduled);
+
+	//! Stores encoder capture result, called from the SSI interrupt
+	void handleEncoderCaptured(EncoderCapture& capture, ErrorCode errorCode);
+
+	//! Posts processing of the inputs, once both they are captured and the
+	//!  write process data slot came, if scheduled. Called from interrupt
+	//!  context
+	void releaseCapturedInputs();
+
+	//! Publishes captured inputs and sends them to the module right away.
+	//!  Late inputs are flagged as stale and optional processing is skipped
+	void processCapturedInputs();
+
+	//! Schedules resendStaleInputs() call from interrupt context
+	void scheduleStaleResendInterruptCtx();
+
+	//! Sends the last inputs again, flagged as stale, so a cycle, whose
+	//!  capture was skipped, still gets process data
+	void resendStaleInputs();
+
+	//! Returns time a cycle has for all its stages: SYNC period in DC mode,
+	//!  the free-run cycle otherwise
+	common::Clock::duration getCyclePeriod() const;
+
+	//! Counts the overrun, from interrupt or event loop context
+	void countOverrun(Overrun overrun);
+
+	//! Returns offset of given time from the SYNC of the current cycle
+	SyncOffset getSyncOffset(common::Clock::time_point time) const;
 
-	void captureEncoder0Inputs();
+	//! Chooses sync mode from the sync object and the ADI map, on entering
+	//!  PROCESS_ACTIVE, when the master can not change it anymore
+	void configureSyncMode();
 
-	void captureEncoder1Inputs();
+	//! Captures inputs in SM-synchronous mode, called from the driver
+	void handleNewReadPd();
 
-	void captureInputsAsync();
+	//! Takes a new latency probe from read process data, called from the
+	//!  driver right after it is copied
+	void handleProbeRequest(common::Clock::time_point receivedTime);
+
+	//! Echoes the pending latency probe, called from the driver right before
+	//!  write process data is copied, so the response goes with that frame
+	void updateProbeResponse(common::Clock::time_point respondedTime);
+
+	//! Captures inputs in free-run mode, and in SM-synchronous mode, when no
+	//!  read process data came within the free-run cycle (e.g. no outputs
+	//!  are mapped)
+	void checkFreeRunCapture(std::uint32_t elapsedMs);
+
+	//! Times SPI frames: process data against SYNC, messages against the
+	//!  moment they were queued
+	void handleSpiSchedEvent(ABCC_SpiSchedEventType event);
+
+	//! Prints and restarts SPI scheduling statistics every report interval
+	void reportSchedStats(std::uint32_t elapsedMs);
+
+	//! Accumulates SYNC periods, publishes them and latency histograms every
+	//!  diagnostics window
+	void updateDiagnostics(std::uint32_t elapsedMs);
+
+	//! Timestamps given point of the current cycle. Points out of order are
+	//!  ignored, so overlapping cycles do not mix. The last one adds the
+	//!  cycle to the histograms. Called from interrupt or event loop context
+	void markCyclePhase(CyclePhase phase, common::Clock::time_point timestamp);
+
+	//! Times the input path with a burst of captures, then publishes the
+	//!  sync object timing and completes the user init
+	void startTimingCalibration();
+
+	//! Records a calibration capture and starts the next one, if any
+	void continueTimingCalibration(common::Clock::duration inputPath);
+
+	//! Publishes input processing and min cycle time in the sync object, if
+	//!  they grew over the published ones. Never lowers them
+	void updateSyncTiming(std::uint32_t inputProcessingNs);
+
+	//! Timestamps given boot phase. Returns false, if it was reached before
+	bool markBootPhase(BootPhase phase);
+
+	//! Prints durations of the boot phases, once PROCESS_ACTIVE is reached
+	void printBootReport();
 
 	State _state = State::Idle;
 	ABP_AnbStateType _anbState = ABP_ANB_STATE_SETUP;
+	//! Test-and-set from both the event loop and interrupts
+	std::atomic<bool> _driverRunPending{false};
+
+	std::array<common::Clock::time_point, BootPhaseCount> _bootTimestamps{};
+	std::uint32_t _bootPhasesReached = 0;
+
+	std::uint32_t _recoveryAttempts = 0; //< Consecutive, 0 if not recovering
+	std::uint32_t _recoveryDelayMs = 0; //< Left until the driver is restarted
+	common::Clock::time_point _recoveryStart{};
+	std::uint32_t _recoveryCount = 0;
+	std::uint32_t _lastRecoveryUs = 0;
+	std::uint32_t _maxRecoveryUs = 0;
+
+	SyncMode _syncMode = SyncMode::DcSynchronous;
+	bool _readPdReceived = false; //< Since the last free-run cycle
+	std::uint32_t _freeRunElapsedMs = 0;
+
+	//! Latency probe taken from read PD, until it is echoed in write PD
+	std::uint16_t _probeSequence = 0; //< Last one taken
+	std::uint32_t _probeMasterTime = 0;
+	common::Clock::time_point _probeReceivedTime{};
+	volatile bool _probePending = false;
+
+	EncoderCapture _encoder0Capture;
+	EncoderCapture _encoder1Capture;
+	std::atomic<std::uint32_t> _pendingEncoders{0};
+	std::atomic<std::uint32_t> _pendingReleases{0}; //< See releaseCapturedInputs()
+	volatile bool _writeSlotPending = false; //< Holds the scheduled capture
+	volatile bool _captureInProgress = false; //< Until inputs are processed
+	volatile bool _syncDeferredPending = false;
+
+	SyncPll _syncPll;
+	ScheduleTimerDevice _scheduleTimer;
+	common::Clock::time_point _scheduleEdge{}; //< Predicted SYNC of the cycle
+	std::size_t _scheduleSlot = 0; //< Next to be run
+	volatile bool _scheduleRunning = false;
+	volatile bool _earlyCaptureStarted = false; //< For the coming SYNC
+
+	//! Deadlines of the current capture, from the cycle start. The PD frame
+	//!  one is from SYNC, see Overrun::PdLate
+	common::Clock::duration _captureBudget{};
+	common::Clock::duration _cycleBudget{};
+	volatile bool _pdDeadlinePending = false; //< Until the PD frame starts
+	volatile bool _staleResendPending = false;
+	std::array<std::atomic<std::uint32_t>, OverrunCount> _overruns{};
+	std::array<std::uint32_t, OverrunCount> _reportedOverruns{};
+
+	SyncMonitor _syncMonitor;
+	std::uint32_t _diagnosticsElapsedMs = 0;
+
+	std::array<common::Clock::time_point, CyclePhaseCount> _cycleTimestamps{};
+	volatile std::size_t _nextCyclePhase = CyclePhaseCount; //< None started
+	//! Of the whole cycle first, then between consecutive phases
+	std::array<LatencyHistogram, CyclePhaseCount> _cycleHistograms{};
+
+	//! Latest SYNC or capture slot in DC mode, SM event or free-run cycle
+	//!  otherwise
+	common::Clock::time_point _cycleStartTime{};
+	//! SYNC edge of the cycle in DC mode, predicted one for a scheduled
+	//!  capture. The cycle start otherwise
+	common::Clock::time_point _cycleSyncTime{};
+	common::Clock::time_point _capturedTime{};
+	common::Clock::time_point _msgQueuedTime{};
+	SyncOffsetStats _captureStartStats;
+	SyncOffsetStats _captureStats; //< To all encoders captured
+	LatencyStats _processStats; //< From capture to processing in event loop
+	SyncOffsetStats _pdFrameStats;
+	LatencyStats _msgStats; //< From message queued to its last fragment
+	std::uint32_t _schedStatsElapsedMs = 0;
+
+	std::uint32_t _calibrationCapturesLeft = 0;
+	common::Clock::duration _calibrationMax{};
+	//! High-water mark of the input path, from cycle start to PD frame end
+	volatile common::Clock::rep _inputPathMax = 0;
+	std::uint32_t _publishedInputProcessingNs = 0;
 
 	common::EventLoop& _eventLoop;
+	common::Clock& _clock;
 	encoders::Encoder0& _encoder0;
 	encoders::Encoder1& _encoder1;
 
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "app/common/Clock.hpp"
+
+namespace app {
+namespace ethercat {
+
+//! Measures period of the SYNC signal, as seen by the device
+//! Edges are only timestamped in the interrupt, statistics are computed
+//!  in the event loop, window by window
+class SyncMonitor
+{
+public:
+	using Clock = common::Clock;
+
+	//! Histogram of period deviation from the reference period. Bins are
+	//!  symmetric around it, the outermost ones take everything beyond
+	constexpr static std::size_t HistogramBins = 16;
+	constexpr static std::uint32_t HistogramBinNs = 250;
+
+	//! Longer periods are gaps, e.g. after SYNC was stopped, not jitter
+	constexpr static std::uint32_t MaxPeriodMs = 1000;
+
+	//! Statistics of a single window, all times in nanoseconds
+	struct Stats
+	{
+		std::uint32_t count = 0; //< Number of periods measured
+		std::uint32_t lost = 0; //< Not processed in time, so not counted
+		std::uint32_t referenceNs = 0; //< Center of the histogram
+		std::uint32_t meanNs = 0;
+		std::uint32_t minNs = 0;
+		std::uint32_t maxNs = 0;
+		std::uint32_t stdDevNs = 0;
+		std::array<std::uint32_t, HistogramBins> histogram{};
+	};
+
+	//! Timestamps SYNC edge, called from interrupt context
+	void recordEdge(Clock::time_point edgeTime)
+	{
+		const auto hadEdge = std::exchange(_hasLastEdge, true);
+		const auto period = (edgeTime - _lastEdge).count();
+		_lastEdge = edgeTime;
+
+		if(!hadEdge || period > MaxPeriodCycles)
+		{
+			return; // Nothing to pair with
+		}
+
+		const auto head = _head.load(std::memory_order_relaxed);
+		if(head - _tail.load(std::memory_order_acquire) == QueueSize)
+		{
+			++_lost;
+			return;
+		}
+
+		_periods[head % QueueSize] = period;
+		_head.store(head + 1, std::memory_order_release);
+	}
+
+	//! Forgets the last edge, so the next one is not paired with it
+	void restart();
+
+	//! Accumulates periods recorded so far, called from event loop context.
+	//!  Has to be called often enough, so the queue does not overflow
+	void update();
+
+	//! Closes the current window and starts next one. Deviations in the next
+	//!  window are counted against the nominal period, if it is known
+	//!  (non-zero), and against the mean period of this window otherwise
+	const Stats& finishWindow(std::uint32_t nominalPeriodNs);
+
+	//! Returns statistics of the last finished window
+	const Stats& getStats() const
+	{
+		return _stats;
+	}
+
+	//! Prints statistics of the last finished window
+	void print() const;
+
+private:
+	//! Room for more than 20 ms of periods at 8 kHz, so a single late tick
+	//!  does not lose anything
+	constexpr static std::uint32_t QueueSize = 256;
+	static_assert((QueueSize & (QueueSize - 1)) == 0,
+		"Queue size has to be a power of two, so indices may wrap around");
+
+	constexpr static Clock::rep MaxPeriodCycles =
+		static_cast<std::uint64_t>(Clock::Frequency) * MaxPeriodMs / 1000;
+
+	constexpr static Clock::rep HistogramBinCycles =
+		static_cast<std::uint64_t>(Clock::Frequency) * HistogramBinNs
+			/ 1000000000;
+	static_assert(HistogramBinCycles > 0,
+		"Histogram bin is shorter than the clock resolution");
+
+	static std::uint32_t toNs(std::uint64_t cycles);
+
+	static Clock::rep toCycles(std::uint32_t ns);
+
+	// Written in interrupt context
+	Clock::time_point _lastEdge{};
+	bool _hasLastEdge = false;
+	std::array<Clock::rep, QueueSize> _periods{};
+	std::atomic<std::uint32_t> _head{0};
+	std::atomic<std::uint32_t> _tail{0};
+	std::atomic<std::uint32_t> _lost{0};
+
+	// Current window, accumulated in event loop context. Sums are taken of
+	//  deviations from the reference, so they stay small
+	Clock::rep _referenceCycles = 0; //< 0 until known
+	std::uint32_t _count = 0;
+	Clock::rep _minCycles = 0;
+	Clock::rep _maxCycles = 0;
+	std::int64_t _sumDeviation = 0;
+	std::uint64_t _sumSquaredDeviation = 0;
+	std::array<std::uint32_t, HistogramBins> _histogram{};
+
+	Stats _stats; //< Of the last finished window
+};
+
+} // namespace ethercat
+} // namespace app
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+#include "app/common/Clock.hpp"
+
+namespace app {
+namespace ethercat {
+
+//! Software PLL, locked to the SYNC signal
+//! Predicts the next SYNC edge on the free-running clock, so work can be
+//!  started ahead of it. It is a second order loop: the period estimate
+//!  integrates the phase error, and a part of the error corrects the
+//!  prediction right away
+class SyncPll
+{
+public:
+	using Clock = common::Clock;
+
+	//! Edges within this phase error count towards the lock
+	constexpr static std::uint32_t LockThresholdNs = 2000;
+
+	//! Number of consecutive edges within the threshold to declare the lock
+	constexpr static std::uint32_t LockEdges = 16;
+
+	//! Lock is lost on a single edge with a larger phase error
+	constexpr static std::uint32_t UnlockThresholdNs = 10000;
+
+	//! Longer periods are gaps, e.g. after SYNC was stopped. The loop
+	//!  acquires the period again after them
+	constexpr static std::uint32_t MaxPeriodMs = 1000;
+
+	//! Feeds the loop with SYNC edge, called from interrupt context
+	void trackEdge(Clock::time_point edgeTime);
+
+	//! Drops the lock and the period estimate, e.g. after the module reset
+	void reset();
+
+	bool isLocked() const
+	{
+		return _locked;
+	}
+
+	//! Predicted time of the next edge, valid only when locked
+	Clock::time_point getNextEdge() const
+	{
+		return Clock::time_point(Clock::duration(_nextEdge));
+	}
+
+	//! Estimated period, zero until acquired
+	Clock::duration getPeriod() const
+	{
+		return Clock::duration(static_cast<Clock::rep>(_periodQ >> FracBits));
+	}
+
+	//! Prints the loop state, if the period was acquired
+	void print() const;
+
+private:
+	//! Period and prediction keep fraction of a clock cycle, so the loop
+	//!  does not dither on the integer part
+	constexpr static unsigned FracBits = 8;
+	constexpr static std::uint32_t FracMask = (1U << FracBits) - 1;
+
+	//! Loop gains are powers of two, Kp = 1/4 and Ki = 1/32. Error decays
+	//!  by ~13 % per edge, with little overshoot
+	constexpr static unsigned ProportionalShift = 2;
+	constexpr static unsigned IntegralShift = 5;
+	static_assert(ProportionalShift <= FracBits && IntegralShift <= FracBits,
+		"Loop gains are finer than the fraction");
+
+	constexpr static std::int32_t LockThresholdCycles =
+		static_cast<std::uint64_t>(Clock::Frequency) * LockThresholdNs
+			/ 1000000000;
+	constexpr static std::int32_t UnlockThresholdCycles =
+		static_cast<std::uint64_t>(Clock::Frequency) * UnlockThresholdNs
+			/ 1000000000;
+
+	constexpr static Clock::rep MaxPeriodCycles =
+		static_cast<std::uint64_t>(Clock::Frequency) * MaxPeriodMs / 1000;
+
+	static std::int32_t toNs(std::int32_t cycles);
+
+	//! Drops the lock, but keeps tracking
+	void unlock();
+
+	// Written in interrupt context
+	Clock::time_point _lastEdge{};
+	bool _hasLastEdge = false;
+	std::uint64_t _periodQ = 0; //< Fixed point, 0 until acquired
+	Clock::rep _nextEdge = 0;
+	std::uint32_t _nextEdgeFrac = 0;
+	std::int32_t _phaseError = 0; //< Of the last edge, in cycles
+	std::uint32_t _edgesInLock = 0; //< Consecutive, within the threshold
+	bool _locked = false;
+	std::uint32_t _lockCount = 0;
+	std::uint32_t _unlockCount = 0;
+};
+
+} // namespace ethercat
+} // namespace app
@@ -15,9 +15,35 @@
 #define ABCC_CFG_OP_MODE_SETTABLE                  (FALSE)
 #define ABCC_CFG_ABCC_OP_MODE_40 ABP_OP_MODE_SPI
 
+//! SPI is the only operating mode, so bind the handler to the SPI driver at
+//! compile time. Driver calls are direct, instead of going through function
+//! pointers selected in ABCC_StartDriver()
+#define ABCC_CFG_DRV_SPI_STATIC_BINDING            (TRUE)
+
 //! Configure SPI message fragment length.
+//! Outside of PROCESS_ACTIVE long fragments are used, so that any message
+//! (12 octets header + max 255 octets data) takes at most two transactions
+#define ABCC_CFG_SPI_MSG_FRAG_LEN                  (136)
+
+//! In PROCESS_ACTIVE short fragments keep the SPI transaction short.
 //! Most of small messages are under 32 octets
-#define ABCC_CFG_SPI_MSG_FRAG_LEN                  (32)
+#define ABCC_CFG_SPI_MSG_FRAG_LEN_CYCLIC           (32)
+
+//! Let uDMA move message fragments straight between the message buffers and
+//! SSI, instead of copying them through the SPI frames
+#define ABCC_CFG_SPI_MSG_ZERO_COPY                 (TRUE)
+
+//! SPI link of the system adaption layer. 16-bit SSI frames halve the number
+//! of FIFO and uDMA operations. The clock starts at the ABCC40 maximum and is
+//! halved on repeated CRC errors, but not below the minimum
+#define ABCC_CFG_SPI_16_BIT_FRAMES                 (TRUE)
+#define ABCC_CFG_SPI_CLOCK_HZ                      (20000000)
+#define ABCC_CFG_SPI_MIN_CLOCK_HZ                  (5000000)
+#define ABCC_CFG_SPI_CLOCK_FALLBACK                (TRUE)
+
+//! Send new write process data in PROCESS_ACTIVE in a frame of its own,
+//! without message field, so messages can not delay it
+#define ABCC_CFG_SPI_PD_PRIORITY                   (TRUE)
 
 //! Enable module ID checking from MI0 and MI1 pins
 #define ABCC_CFG_MODULE_ID_PINS_CONN               (FALSE)
@@ -29,23 +55,36 @@
 #define ABCC_CFG_MAX_NUM_APPL_CMDS                 (2)
 #define ABCC_CFG_MAX_NUM_ABCC_CMDS                 (2)
 #define ABCC_CFG_MAX_MSG_SIZE                      (255)
-#define ABCC_CFG_MAX_PROCESS_DATA_SIZE             (512)
+//! One message buffer more than the default, since the SPI driver holds the
+//! buffer for the next read message in advance (ABCC_CFG_SPI_MSG_ZERO_COPY)
+#define ABCC_CFG_MAX_NUM_MSG_RESOURCES             (ABCC_CFG_MAX_NUM_APPL_CMDS + \
+                                                    ABCC_CFG_MAX_NUM_ABCC_CMDS + 1)
+//! Process data buffers, including the SPI frames, are sized for the ADI map.
+//! Both encoders inputs (UINT16 position + BIT4 status each) and the latency
+//! probe response (UINT16 + 3x UINT32) are write mappable, the latency probe
+//! request (UINT16 + UINT32) is read mappable. Checked against the map at
+//! compile time in EtherCAT.cpp
+#define ABCC_CFG_MAX_PROCESS_DATA_SIZE             (19)
 
 //! Enable both SYNC and usage of SYNC signal
 #define ABCC_CFG_SYNC_ENABLE                    (TRUE)
 #define ABCC_CFG_USE_ABCC_SYNC_SIGNAL           (TRUE)
 
-//! Enable interrupts from IRQ pin
+//! Enable interrupts from IRQ pin.
+//! ABCC asserts IRQ on new read PD, new read message, anybus state change and
+//! status change, so ABCC_RunDriver() is invoked only when there is work to do
 #define ABCC_CFG_POLL_ABCC_IRQ_PIN                 (FALSE)
 #define ABCC_CFG_INT_ENABLED                       (TRUE)
-#define ABCC_CFG_INT_ENABLE_MASK_SPI (0)
-// #define ABCC_CFG_INT_ENABLE_MASK_SPI (ABP_INTMASK_RDPDIEN | ABP_INTMASK_RDMSGIEN | ABP_INTMASK_WRMSGIEN | ABP_INTMASK_ANBRIEN | ABP_INTMASK_STATUSIEN)
+#define ABCC_CFG_INT_ENABLE_MASK_SPI               (ABP_INTMASK_RDPDIEN | \
+                                                    ABP_INTMASK_RDMSGIEN | \
+                                                    ABP_INTMASK_ANBRIEN | \
+                                                    ABP_INTMASK_STATUSIEN)
 
 //! Configure anybus watchdog to be called every 1 second
 #define ABCC_CFG_WD_TIMEOUT_MS                     (1000)
 
-//! Disable remapping
-#define ABCC_CFG_REMAP_SUPPORT_ENABLED             (FALSE)
+//! Enable remapping, so the master can shrink the process data to what it needs
+#define ABCC_CFG_REMAP_SUPPORT_ENABLED             (TRUE)
 
 //! Configuration of ADI
 #define ABCC_CFG_STRUCT_DATA_TYPE                  (TRUE)
@@ -58,3 +58,16 @@
 //! Uses internally ABCC_PORT_CopyOctets (with nbytes=4)
 #define ABCC_PORT_Copy32( dst, dstOffset, src, srcOffset ) \
     ABCC_PORT_CopyOctets(dst, dstOffset, src, srcOffset, 4)
+
+//! Swaps octets of a word. Replaces the generic shift based swap from abcc.h,
+//! the builtin is a single REV16 instruction on Cortex-M4
+#define ABCC_iEndianSwap( iFoo ) \
+    ((UINT16)__builtin_bswap16((UINT16)(iFoo)))
+
+//! Swaps octets of a dword. Single REV instruction on Cortex-M4
+#define ABCC_lEndianSwap( lFoo ) \
+    ((UINT32)__builtin_bswap32((UINT32)(lFoo)))
+
+//! Swaps octets of a qword. Two REV instructions on Cortex-M4
+#define ABCC_l64EndianSwap( lFoo ) \
+    ((UINT64)__builtin_bswap64((UINT64)(lFoo)))
@@ -13,9 +13,23 @@
 ** continuous ranges of elements to map.
 ** Do not forget to consider remap scenarios if ABCC_CFG_REMAP_SUPPORT_ENABLED
 ** is enabled in abcc_drv_cfg.h.
+** Here each of the 4 write mappable encoder inputs elements and each of the 4
+** write mappable latency probe response elements may be remapped separately,
+** as well as each of the 2 read mappable latency probe request elements.
+** Checked against the ADI map at compile time in EtherCAT.cpp.
 */
-#define AD_MAX_NUM_WRITE_MAP_ENTRIES             ( 64 )
-#define AD_MAX_NUM_READ_MAP_ENTRIES              ( 64 )
+#define AD_MAX_NUM_WRITE_MAP_ENTRIES             ( 8 )
+#define AD_MAX_NUM_READ_MAP_ENTRIES              ( 2 )
+
+/*
+** Max number of steps of the precomputed process data copy plans.
+** Each mapped range of a plain ADI and each mapped structure element takes one
+** step, each mapping of an ADI with a get/set callback takes one more.
+** If a (re)map does not fit, the process data is updated by walking the map,
+** which is correct but slower.
+*/
+#define AD_MAX_NUM_WRITE_COPY_STEPS              ( 8 )
+#define AD_MAX_NUM_READ_COPY_STEPS               ( 2 )
 
 /*
 ** Attributes 5, 6, 7: Min, max and default attributes  - (BOOL - TRUE/FALSE)
@@ -36,6 +36,8 @@
 **    ABCC_RunTimerSystem()               - Timer information to ABCC.
 **    ABCC_RunDriver()                    - Main routine to be called cyclically
 **                                          during polling.
+**    ABCC_IsRunDriverPending()           - Check if ABCC_RunDriver() shall be
+**                                          called again (event driven mode).
 **    ABCC_UserInitComplete()             - End of user specific setup sequence.
 **    ABCC_SendCmdMsg()                   - Sends a message command to ABCC.
 **    ABCC_SendRespMsg()                  - Sends a message response to ABCC.
@@ -76,6 +78,7 @@
 ** ABCC_CbfRemapDone()                 - Acknowledge of remap has been sent.
 ** ABCC_CbfAnbStateChanged()           - The anybus state has changed.
 ** ABCC_CbfSyncIsr()                   - Callback for sync event.
+** ABCC_CbfSpiSchedEvent()             - SPI frame scheduling event.
 ********************************************************************************
 ********************************************************************************
 */
@@ -228,6 +231,25 @@ typedef enum ABCC_CommunicationState
 ABCC_CommunicationStateType;
 
 
+/*------------------------------------------------------------------------------
+** SPI frame scheduling events, indicated by ABCC_CbfSpiSchedEvent().
+**
+** ABCC_SPI_SCHED_MSG_QUEUED: Write message handed over to the SPI driver.
+** ABCC_SPI_SCHED_MSG_SENT:   MOSI frame with the last fragment of the write
+**                            message is about to be sent.
+** ABCC_SPI_SCHED_PD_FRAME:   MOSI frame with new write process data is about
+**                            to be sent.
+**------------------------------------------------------------------------------
+*/
+typedef enum ABCC_SpiSchedEvent
+{
+   ABCC_SPI_SCHED_MSG_QUEUED = 0,
+   ABCC_SPI_SCHED_MSG_SENT = 1,
+   ABCC_SPI_SCHED_PD_FRAME = 2
+}
+ABCC_SpiSchedEventType;
+
+
 /*------------------------------------------------------------------------------
 ** Used for storing the data format of the field bus.
 ** NET_UNKNOWN means that the Anybus-CC has not yet responded to our command to
@@ -759,7 +781,30 @@ EXTFUNC ABCC_CommunicationStateType ABCC_isReadyForCommunication( void );
 **    None
 **------------------------------------------------------------------------------
 */
+#if( ABCC_CFG_DRV_SPI_STATIC_BINDING )
+EXTFUNC void ABCC_SpiISR( void );
+#define ABCC_ISR ABCC_SpiISR
+#else
 EXTFUNC void ( *ABCC_ISR )( void );
+#endif
+
+/*------------------------------------------------------------------------------
+** Used when ABCC_RunDriver() is invoked on events (ABCC IRQ, end of SPI
+** transfer, SYNC) instead of being polled. Checks if the driver has work which
+** can be done right now and requires another call to ABCC_RunDriver(), e.g. a
+** pending write process data update, an unfinished message fragmentation, a
+** retransmission or an ABCC interrupt still being active.
+** While a transfer is ongoing FALSE is returned, since the end of the transfer
+** is an event on its own.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    TRUE if ABCC_RunDriver() shall be called again.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ABCC_IsRunDriverPending( void );
 
 /*------------------------------------------------------------------------------
 ** This function is responsible for handling all timers for the ABCC-driver. It
@@ -816,7 +861,12 @@ EXTFUNC void ABCC_HWReleaseReset( void );
 **    ABCC_ErrorCodeType
 **------------------------------------------------------------------------------
 */
+#if( ABCC_CFG_DRV_SPI_STATIC_BINDING )
+EXTFUNC ABCC_ErrorCodeType ABCC_SpiRunDriver( void );
+#define ABCC_RunDriver ABCC_SpiRunDriver
+#else
 EXTFUNC ABCC_ErrorCodeType (*ABCC_RunDriver)( void );
+#endif
 
 /*------------------------------------------------------------------------------
 ** This function should be called by the application when the last response from
@@ -1178,6 +1228,23 @@ EXTFUNC void ABCC_CbfEvent( UINT16 iEvents);
 EXTFUNC void ABCC_CbfSyncIsr( void );
 #endif
 
+/*------------------------------------------------------------------------------
+** If ABCC_CFG_SPI_PD_PRIORITY is enabled this function is invoked by the SPI
+** driver, so the application may time the MOSI frames, e.g. against the sync
+** event. Invoked in the same context as ABCC_RunDriver() and
+** ABCC_SendCmdMsg()/ABCC_SendRespMsg(), so it shall return quickly.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eEvent - Scheduling event, see ABCC_SpiSchedEventType.
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+#if( ABCC_CFG_DRV_SPI && ABCC_CFG_SPI_PD_PRIORITY )
+EXTFUNC void ABCC_CbfSpiSchedEvent( ABCC_SpiSchedEventType eEvent );
+#endif
+
 
 /*------------------------------------------------------------------------------
 ** This function needs to be implemented by the application. The function is
@@ -1401,7 +1468,12 @@ EXTFUNC void ABCC_TriggerReceiveMessage( void );
 **    None
 **------------------------------------------------------------------------------
 */
+#if( ABCC_CFG_DRV_SPI_STATIC_BINDING )
+EXTFUNC void ABCC_SpiTriggerWrPdUpdate( void );
+#define ABCC_TriggerWrPdUpdate ABCC_SpiTriggerWrPdUpdate
+#else
 EXTFUNC void (*ABCC_TriggerWrPdUpdate)( void );
+#endif
 
 /*------------------------------------------------------------------------------
 ** Check if current anybus status has changed.
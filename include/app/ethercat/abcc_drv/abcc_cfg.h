@@ -195,6 +195,25 @@
 **------------------------------------------------------------------------------
 */
 
+/*------------------------------------------------------------------------------
+** #define ABCC_CFG_DRV_SPI_STATIC_BINDING   (BOOL - TRUE/FALSE )
+**
+** Defined in abcc_drv_cfg.h.
+**
+** If TRUE the handler is bound to the SPI driver at compile time. The
+** pnABCC_DrvXxx() driver functions and the ABCC_RunDriver(), ABCC_ISR() and
+** ABCC_TriggerWrPdUpdate() handler functions resolve directly to their SPI
+** implementations instead of function pointers assigned by ABCC_StartDriver().
+** The calls are direct, with no pointer load in between. They are not
+** inlined across translation units, as the firmware is built without link
+** time optimization.
+**
+** Requires that "ABCC_CFG_DRV_SPI" is the only low-level driver included.
+** The operating mode read at startup must still be ABP_OP_MODE_SPI.
+** The default behavior, if not defined at all, is FALSE.
+**------------------------------------------------------------------------------
+*/
+
 /*------------------------------------------------------------------------------
 ** #define ABCC_CFG_OP_MODE_GETTABLE         (BOOL - TRUE/FALSE )
 **
@@ -259,6 +278,80 @@
 **------------------------------------------------------------------------------
 */
 
+/*------------------------------------------------------------------------------
+** #define ABCC_CFG_SPI_MSG_FRAG_LEN_CYCLIC            ( 32 )
+**
+** Defined in abcc_drv_cfg.h.
+**
+** Length of SPI message fragment in bytes per SPI transaction, used while the
+** ABCC is in PROCESS_ACTIVE. In all other states ABCC_CFG_SPI_MSG_FRAG_LEN is
+** used, so startup and enumeration messages are transferred in few
+** transactions, while the cyclic transactions are kept short. The length is
+** only switched between messages. Must not exceed ABCC_CFG_SPI_MSG_FRAG_LEN.
+**------------------------------------------------------------------------------
+*/
+
+/*------------------------------------------------------------------------------
+** #define ABCC_CFG_SPI_PD_PRIORITY             (BOOL - TRUE/FALSE)
+**
+** Defined in abcc_drv_cfg.h.
+**
+** If TRUE, while the ABCC is in PROCESS_ACTIVE, a MOSI frame with new write
+** process data is sent without message field (message length 0), so it is as
+** short as possible and never waits for message fragments. Message fragments
+** are sent in the next frame, which always has the message field, so messages
+** are delayed by one frame at most. The length is only switched between
+** messages, so a message already being fragmented is not held back.
+** The SPI driver reports the scheduling events through ABCC_CbfSpiSchedEvent(),
+** which must be implemented by the application.
+** The default behavior, if not defined at all, is FALSE.
+**------------------------------------------------------------------------------
+*/
+
+/*------------------------------------------------------------------------------
+** #define ABCC_CFG_SPI_MSG_ZERO_COPY           (BOOL - TRUE/FALSE)
+**
+** Defined in abcc_drv_cfg.h.
+**
+** If TRUE the SPI driver does not copy message fragments between the message
+** buffers and the SPI frames. Each frame is instead handed over to the system
+** adaption layer as a list of segments (frame header, message fragment and
+** the rest of the frame), which is transferred by scatter-gather. The read
+** message buffer is allocated before the transfer, so it is held by the driver
+** also when no message is being received. If no buffer is available the
+** fragment is received into the frame and copied, as when FALSE.
+** If TRUE ABCC_SYS_SpiSendReceiveSegments() must be implemented in the system
+** adaption layer.
+** The default behavior, if not defined at all, is FALSE.
+**------------------------------------------------------------------------------
+*/
+
+/*------------------------------------------------------------------------------
+** #define ABCC_CFG_SPI_16_BIT_FRAMES           (BOOL - TRUE/FALSE)
+**
+** Defined in abcc_drv_cfg.h.
+**
+** If TRUE the system adaption layer moves the SPI frames as 16-bit words and
+** may swap their octets for the transfer. The SPI driver then calls
+** ABCC_SYS_SpiFinishTransfer() for every received MISO frame, before it is
+** checked, which must be implemented in the system adaption layer.
+** The default behavior, if not defined at all, is FALSE.
+**------------------------------------------------------------------------------
+*/
+
+/*------------------------------------------------------------------------------
+** #define ABCC_CFG_SPI_CLOCK_FALLBACK          (BOOL - TRUE/FALSE)
+**
+** Defined in abcc_drv_cfg.h.
+**
+** If TRUE the SPI driver reports the result of the CRC check of every MISO
+** frame to the system adaption layer, so it can step the SPI clock down when
+** CRC errors repeat. ABCC_SYS_SpiFrameCrcChecked() must then be implemented in
+** the system adaption layer.
+** The default behavior, if not defined at all, is FALSE.
+**------------------------------------------------------------------------------
+*/
+
 /*------------------------------------------------------------------------------
 ** #define ABCC_CFG_MEMORY_MAPPED_ACCESS        (BOOL - TRUE/FALSE)
 **
@@ -608,6 +608,45 @@ EXTFUNC BOOL ( *pnABCC_DrvIsSupervised )( void );
 */
 EXTFUNC UINT8 ( *pnABCC_DrvGetAnbStatus )( void );
 
+/*------------------------------------------------------------------------------
+** Static binding to the SPI driver, see ABCC_CFG_DRV_SPI_STATIC_BINDING.
+** The driver functions above resolve directly to the SPI implementation.
+** Functions not implemented by the SPI driver are null function pointers, so
+** the NULL checks done by the callers still apply.
+**------------------------------------------------------------------------------
+*/
+#if( ABCC_CFG_DRV_SPI_STATIC_BINDING )
+#if( !ABCC_CFG_DRV_SPI || ABCC_CFG_DRV_PARALLEL || ABCC_CFG_DRV_PARALLEL_30 || ABCC_CFG_DRV_SERIAL )
+#error "ABCC_CFG_DRV_SPI_STATIC_BINDING requires SPI to be the only driver"
+#endif
+
+#include "spi/abcc_drv_spi_if.h"
+
+#define pnABCC_DrvInit                    ABCC_DrvSpiInit
+#define pnABCC_DrvISR                     ( (UINT16 (*)( void ))NULL )
+#define pnABCC_DrvRunDriverTx             ABCC_DrvSpiRunDriverTx
+#define pnABCC_DrvRunDriverRx             ABCC_DrvSpiRunDriverRx
+#define pnABCC_DrvPrepareWriteMessage     ( (void (*)( ABP_MsgType* ))NULL )
+#define pnABCC_DrvWriteMessage            ABCC_DrvSpiWriteMessage
+#define pnABCC_DrvWriteProcessData        ABCC_DrvSpiWriteProcessData
+#define pnABCC_DrvISReadyForWrPd          ABCC_DrvSpiIsReadyForWrPd
+#define pnABCC_DrvISReadyForWriteMessage  ABCC_DrvSpiIsReadyForWriteMessage
+#define pnABCC_DrvISReadyForCmd           ABCC_DrvSpiIsReadyForCmd
+#define pnABCC_DrvSetNbrOfCmds            ABCC_DrvSpiSetNbrOfCmds
+#define pnABCC_DrvSetAppStatus            ABCC_DrvSpiSetAppStatus
+#define pnABCC_DrvSetPdSize               ABCC_DrvSpiSetPdSize
+#define pnABCC_DrvSetIntMask              ABCC_DrvSpiSetIntMask
+#define pnABCC_DrvGetWrPdBuffer           ABCC_DrvSpiGetWrPdBuffer
+#define pnABCC_DrvGetModCap               ABCC_DrvSpiGetModCap
+#define pnABCC_DrvGetLedStatus            ABCC_DrvSpiGetLedStatus
+#define pnABCC_DrvGetIntStatus            ABCC_DrvSpiGetIntStatus
+#define pnABCC_DrvGetAnybusState          ABCC_DrvSpiGetAnybusState
+#define pnABCC_DrvReadProcessData         ABCC_DrvSpiReadProcessData
+#define pnABCC_DrvReadMessage             ABCC_DrvSpiReadMessage
+#define pnABCC_DrvIsSupervised            ABCC_DrvSpiIsSupervised
+#define pnABCC_DrvGetAnbStatus            ABCC_DrvSpiGetAnbStatus
+#endif
+
 #endif  /* inclusion lock */
 
 /*******************************************************************************
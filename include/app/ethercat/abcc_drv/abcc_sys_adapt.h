@@ -147,7 +147,8 @@ EXTFUNC void ABCC_SYS_HWReleaseReset( void );
 
 /*------------------------------------------------------------------------------
 ** This function shall be able to read the interrupt signal from the ABCC. It is
-** used to enable polling of interrupts if they should not be enabled.
+** used to enable polling of interrupts if they should not be enabled, and to
+** detect events still pending after the interrupt edge has been handled.
 **------------------------------------------------------------------------------
 ** Arguments:
 **       None.
@@ -156,7 +157,7 @@ EXTFUNC void ABCC_SYS_HWReleaseReset( void );
 **       Returns TRUE if an interrupt is active, otherwise it returns FALSE.
 **------------------------------------------------------------------------------
 */
-#if( ABCC_CFG_POLL_ABCC_IRQ_PIN )
+#if( ABCC_CFG_POLL_ABCC_IRQ_PIN || ABCC_CFG_INT_ENABLED )
 EXTFUNC BOOL ABCC_SYS_IsAbccInterruptActive( void );
 #endif
 
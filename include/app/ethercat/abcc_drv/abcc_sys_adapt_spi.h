@@ -29,6 +29,10 @@
 ** Services:
 ** ABCC_SYS_SpiRegDataReceived() - MISO received
 ** ABCC_SYS_SpiSendReceive()          - Start transaction
+** ABCC_SYS_SpiSendReceiveSegments()  - Start transaction (scatter-gather)
+** ABCC_SYS_SpiFinishTransfer()       - Restore frames of a finished transaction
+** ABCC_SYS_SpiFrameCrcChecked()      - MISO frame CRC checked
+** ABCC_CbfSpiTransferDone()          - Transaction finished (callback)
 ********************************************************************************
 ********************************************************************************
 */
@@ -54,6 +58,16 @@
 */
 typedef void ( *ABCC_SYS_SpiDataReceivedCbfType )( void );
 
+/*------------------------------------------------------------------------------
+** Buffer holding a part of the SPI frame, see ABCC_SYS_SpiSendReceiveSegments().
+** ------------------------------------------------------------------------------
+*/
+typedef struct ABCC_SYS_SpiSegmentType
+{
+   void*  pxData;                         /* Start of the segment. */
+   UINT16 iLength;                        /* Length of the segment ( in bytes ). */
+} ABCC_SYS_SpiSegmentType;
+
 /*******************************************************************************
 ** Public Globals
 ********************************************************************************
@@ -100,4 +114,81 @@ EXTFUNC void ABCC_SYS_SpiRegDataReceived( ABCC_SYS_SpiDataReceivedCbfType pnData
 */
 EXTFUNC void ABCC_SYS_SpiSendReceive( void* pxSendDataBuffer, void* pxReceiveDataBuffer, UINT16 iLength );
 
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+/*------------------------------------------------------------------------------
+** ABCC_SYS_SpiSendReceiveSegments()
+** Same as ABCC_SYS_SpiSendReceive(), but both the MOSI and the MISO frame are
+** given as lists of up to ABCC_SYS_SPI_MAX_NUM_SEGMENTS segments, which are
+** sent and received in order, as one SPI frame. Both lists cover the same
+** number of bytes. The segment lists are only used during the call, but the
+** buffers must stay valid until the MISO frame received callback is invoked.
+**------------------------------------------------------------------------------
+** Arguments:
+**             psSendSegments       Segments of the MOSI frame.
+**             bNumSendSegments     Number of MOSI frame segments.
+**             psReceiveSegments    Segments of the MISO frame.
+**             bNumReceiveSegments  Number of MISO frame segments.
+** Returns:
+**          None.
+**------------------------------------------------------------------------------
+*/
+#define ABCC_SYS_SPI_MAX_NUM_SEGMENTS 3
+
+EXTFUNC void ABCC_SYS_SpiSendReceiveSegments( const ABCC_SYS_SpiSegmentType* psSendSegments,
+                                              UINT8 bNumSendSegments,
+                                              const ABCC_SYS_SpiSegmentType* psReceiveSegments,
+                                              UINT8 bNumReceiveSegments );
+#endif
+
+#if( ABCC_CFG_SPI_16_BIT_FRAMES )
+/*------------------------------------------------------------------------------
+** ABCC_SYS_SpiFinishTransfer()
+** Called by the SPI driver for every received MISO frame, before its CRC is
+** checked. The system adaption layer brings octets of both frames of the
+** transaction back to memory order, if it changed them for the transfer. It is
+** called from the driver context, so the work is kept out of the transfer
+** interrupt.
+**------------------------------------------------------------------------------
+** Arguments:
+**          None.
+** Returns:
+**          None.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_SYS_SpiFinishTransfer( void );
+#endif
+
+#if( ABCC_CFG_SPI_CLOCK_FALLBACK )
+/*------------------------------------------------------------------------------
+** ABCC_SYS_SpiFrameCrcChecked()
+** Called by the SPI driver for every received MISO frame, once its CRC has been
+** checked. A frame with invalid CRC is retransmitted by the driver. On repeated
+** errors the system adaption layer may lower the SPI clock. It is called
+** between transfers, so the SPI hardware may be reconfigured.
+**------------------------------------------------------------------------------
+** Arguments:
+**          fCrcValid            TRUE if the CRC of the MISO frame was valid.
+** Returns:
+**          None.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_SYS_SpiFrameCrcChecked( BOOL fCrcValid );
+#endif
+
+/*------------------------------------------------------------------------------
+** ABCC_CbfSpiTransferDone()
+** Called by the low level SPI hardware driver, from interrupt context, right
+** after the callback registered by ABCC_SYS_SpiRegDataReceived() has been
+** invoked. The application shall schedule ABCC_RunDriver(), so the received
+** MISO frame gets processed and the next MOSI frame may be sent.
+** Must be implemented by the application.
+**------------------------------------------------------------------------------
+** Arguments:
+**          None.
+** Returns:
+**          None.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_CbfSpiTransferDone( void );
+
 #endif  /* inclusion lock */
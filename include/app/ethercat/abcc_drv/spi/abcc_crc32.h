@@ -29,6 +29,8 @@
 ** Services:
 **
 **    CRC_Crc32()                   - CRC32 checksum calculation function.
+**    CRC_Crc32Update()             - CRC32 calculation over a part of data.
+**    CRC_Crc32Final()              - CRC32 checksum of the updated parts.
 ********************************************************************************
 ********************************************************************************
 */
@@ -69,6 +71,45 @@
 
 EXTFUNC UINT32 CRC_Crc32( UINT16* piBufferStart, UINT16 iLength );
 
+/*------------------------------------------------------------------------------
+** CRC_Crc32Update()
+**
+** Continues the CRC32 calculation on the indicated bytes. Used when the data
+** is not contiguous. The calculation is started with 0 and the checksum is
+** returned by CRC_Crc32Final().
+**------------------------------------------------------------------------------
+** Inputs:
+**    lCrc                     - Value returned by the previous call or 0.
+**    pbBufferStart            - Where to continue the calculation.
+**    iLength                  - The amount of bytes to include (even).
+**
+** Outputs:
+**    Returns                  - Intermediate value of the calculation.
+**
+** Usage:
+**    lCrc = CRC_Crc32Update( 0, piHeader, 8 );
+**    lCrc = CRC_Crc32Update( lCrc, piData, 20 );
+**    lCrc = CRC_Crc32Final( lCrc );
+**------------------------------------------------------------------------------
+*/
+
+EXTFUNC UINT32 CRC_Crc32Update( UINT32 lCrc, UINT16* piBufferStart, UINT16 iLength );
+
+/*------------------------------------------------------------------------------
+** CRC_Crc32Final()
+**
+** Completes the calculation started by CRC_Crc32Update().
+**------------------------------------------------------------------------------
+** Inputs:
+**    lCrc                     - Value returned by CRC_Crc32Update().
+**
+** Outputs:
+**    Returns                  - The calculated CRC32 checksum for the SPI.
+**------------------------------------------------------------------------------
+*/
+
+EXTFUNC UINT32 CRC_Crc32Final( UINT32 lCrc );
+
 
 
 #endif  /* inclusion lock */
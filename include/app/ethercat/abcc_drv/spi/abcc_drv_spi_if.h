@@ -33,6 +33,8 @@
 **       ABCC_DrvSpiWriteProcessData()          - Writes current process data.
 **       ABCC_DrvSpiIsReadyForWriteMessage()    - Checks if the driver is ready to send a new write message.
 **       ABCC_DrvSpiIsReadyForCmd()             - Checks if the Anybus is ready to receive a new command message.
+**       ABCC_DrvSpiIsTransferPending()         - Checks if another SPI frame shall be sent right away.
+**       ABCC_DrvSpiIsTransferOngoing()         - Checks if an SPI frame is being transferred.
 **       ABCC_DrvSpiSetNbrOfCmds()              - Sets the number of simultaneous commands that is supported by the application.
 **       ABCC_DrvSpiSetAppStatus()              - Sets the current application status.
 **       ABCC_DrvSpiSetPdSize()                 - Sets the current process data size.
@@ -211,6 +213,39 @@ EXTFUNC BOOL ABCC_DrvSpiIsReadyForWriteMessage( void );
 EXTFUNC BOOL ABCC_DrvSpiIsReadyForCmd( void );
 
 
+/*------------------------------------------------------------------------------
+** Checks if the driver has to send another SPI frame without waiting for any
+** external event. This is the case when the driver is not initialized yet, a
+** retransmission is requested, a message fragmentation is not finished, or
+** new write process data or application status is waiting to be sent.
+**------------------------------------------------------------------------------
+** Arguments:
+**       None.
+**
+** Returns:
+**       True:          Another MOSI frame shall be sent.
+**       False:         Transfer ongoing or nothing left to be sent.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ABCC_DrvSpiIsTransferPending( void );
+
+
+/*------------------------------------------------------------------------------
+** Checks if an SPI frame is being transferred. The MOSI and MISO frames are
+** double buffered, so write process data may still be written and the latest
+** read process data and messages read meanwhile.
+**------------------------------------------------------------------------------
+** Arguments:
+**       None.
+**
+** Returns:
+**       True:          Waiting for the MISO frame.
+**       False:         No transfer ongoing.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ABCC_DrvSpiIsTransferOngoing( void );
+
+
 /*------------------------------------------------------------------------------
 ** Sets the number of simultaneous commands that is supported by the application.
 **------------------------------------------------------------------------------
@@ -239,7 +274,8 @@ EXTFUNC void ABCC_DrvSpiSetAppStatus( ABP_AppStatusType eAppStatus );
 
 
 /*------------------------------------------------------------------------------
-** Sets the current process data size.
+** Sets the current process data size. The new size is used from the next
+** MOSI frame on, a transfer that is already ongoing keeps the current size.
 **------------------------------------------------------------------------------
 ** Arguments:
 **       iReadPdSize:   Size of read process data (bytes)
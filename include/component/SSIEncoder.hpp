@@ -72,11 +72,32 @@ public:
 
 		// Store provided handler
 		_readHandler = std::forward<TFunc>(func);
+		_readHandlerInterruptCtx = false;
 
 		// Begin asynchronous read
 		_ssiMasterDevice.startReadOne(&_data, EventLoopCtx());
 	}
 
+	//! Reads encoder position value asynchronously. May be called from
+	//!  interrupt context, handler is invoked directly from device interrupt
+	template<typename TFunc>
+	void asyncReadPositionInterruptCtx(Position* destPosition, TFunc&& func)
+	{
+		// Driver should not be busy
+		assert(!isBusy());
+
+		// Check correctness of input arguments
+		assert(destPosition != nullptr);
+		_destPosition = destPosition;
+
+		// Store provided handler
+		_readHandler = std::forward<TFunc>(func);
+		_readHandlerInterruptCtx = true;
+
+		// Begin asynchronous read
+		_ssiMasterDevice.startReadOne(&_data, InterruptCtx());
+	}
+
 	//! Reads encoder position value. Blocking call.
 	void readPosition(Position& destPosition, ErrorCode& errorCode)
 	{
@@ -132,6 +153,14 @@ private:
 			*_destPosition = position;
 		}
 
+		if(_readHandlerInterruptCtx)
+		{
+			// Caller is waiting in interrupt context, so do not delay it
+			assert(_readHandler);
+			_readHandler(errorCode);
+			return;
+		}
+
 		// Post callback with appriopriate errorCode
 		const auto postSuccess = _eventLoop.postInterruptCtx(
 			[this, errorCode]()
@@ -151,6 +180,7 @@ private:
 	}
 
 	ReadHandler _readHandler; //< Handler to be invoked after asyncReadPosition
+	bool _readHandlerInterruptCtx = false; //< Invoke handler directly from ISR
 	DataType _data; //< Buffer used in read operations
 	Position* _destPosition = nullptr; //< Not owning pointer used in async operations
 	EventLoop& _eventLoop;
@@ -168,11 +168,6 @@ public:
 		return waitCancelled;
 	}
 
-private:
-	template<typename T> using Function = embxx::util::StaticFunction<T, 2 * sizeof(void*)>;
-
-	using TimeoutHandler = Function<void()>;
-
 	/**
 	 * @brief Starts asynchronous wait, from interrupt context
 	 * @details [long description]
@@ -204,6 +199,13 @@ private:
 		TimerEnable(BaseAddress, TIMER_BOTH);
 	}
 
+	/**
+	 * @brief Cancels asynchronous wait, from interrupt context
+	 * @details [long description]
+	 *
+	 * @param  [description]
+	 * @return [description]
+	 */
 	bool cancelWait(InterruptCtx)
 	{
 		if(isBusy(InterruptCtx()))
@@ -225,6 +227,11 @@ private:
 		return false;
 	}
 
+private:
+	template<typename T> using Function = embxx::util::StaticFunction<T, 2 * sizeof(void*)>;
+
+	using TimeoutHandler = Function<void()>;
+
 	bool isBusy(InterruptCtx)
 	{
 		if(TimerIsEnabled(BaseAddress, TIMER_A))
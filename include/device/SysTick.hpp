@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+#include "tivaware/inc/hw_ints.h"
+
+#include "embxx/util/StaticFunction.h"
+#include "embxx/device/context.h"
+
+#include "util/driverlib/systick.hpp"
+
+#include "init.hpp"
+
+namespace device {
+
+//! Periodic tick, generated by the Cortex-M SysTick core timer.
+//! Since SysTick is not a SysCtl peripheral, it is not a `Peripheral`
+template<std::uint32_t TPeriodMs>
+class SysTick
+{
+public:
+	constexpr static std::uint32_t PeriodMs = TPeriodMs;
+	static_assert(PeriodMs > 0,
+		"Specified PeriodMs is invalid");
+
+	constexpr static int Frequency = ClockHz;
+
+	constexpr static std::uint32_t PeriodTicks =
+		static_cast<std::uint64_t>(Frequency) * PeriodMs / 1000;
+	static_assert(PeriodTicks > 0 && PeriodTicks <= (1U << 24),
+		"SysTick counter is only 24-bit wide");
+
+	using EventLoopCtx = embxx::device::context::EventLoop;
+	using InterruptCtx = embxx::device::context::Interrupt;
+
+	/**
+	 * @brief Constructor
+	 * @details [long description]
+	 */
+	SysTick()
+	{
+		// Only one SysTick is present in the core
+		assert(_instance == nullptr);
+		_instance = this;
+
+		// Be sure, that during construction SysTick is disabled
+		assert(!isRunning());
+
+		MAP_SysTickPeriodSet(PeriodTicks);
+
+		// SysTick vector is not a part of the NVIC, so register it directly
+		SysTickIntRegister(sysTickISR);
+	}
+
+	/**
+	 * @brief Destructor
+	 * @details [long description]
+	 */
+	~SysTick()
+	{
+		stop();
+
+		SysTickIntUnregister();
+		_instance = nullptr;
+	}
+
+	/**
+	 * @brief Sets tick handler, invoked from interrupt context every period
+	 * @details [long description]
+	 *
+	 * @param handler [description]
+	 */
+	template<typename THandler>
+	void setTickHandler(THandler&& handler)
+	{
+		// Handler may be changed only when device is stopped
+		assert(!isRunning());
+
+		_tickHandler = std::forward<THandler>(handler);
+	}
+
+	/**
+	 * @brief Starts periodic ticking
+	 * @details [long description]
+	 */
+	void start()
+	{
+		assert(!isRunning());
+		assert(_tickHandler);
+
+		// Restart counting from the full period
+		SysTickClear();
+
+		MAP_SysTickIntEnable();
+		MAP_SysTickEnable();
+	}
+
+	/**
+	 * @brief Stops periodic ticking
+	 * @details [long description]
+	 */
+	void stop()
+	{
+		MAP_SysTickDisable();
+		MAP_SysTickIntDisable();
+	}
+
+	/**
+	 * @brief Checks, whether device is ticking or not
+	 * @details [long description]
+	 *
+	 * @return [description]
+	 */
+	bool isRunning() const
+	{
+		return SysTickIsEnabled();
+	}
+
+private:
+	template<typename T> using Function = embxx::util::StaticFunction<T, 2 * sizeof(void*)>;
+
+	using TickHandler = Function<void()>;
+
+	void handleISR(InterruptCtx)
+	{
+		assert(_tickHandler);
+		_tickHandler();
+	}
+
+	static void sysTickISR()
+	{
+		// SysTick has no entry in the IntUserData array, so use stored instance
+		assert(_instance != nullptr);
+		_instance->handleISR(InterruptCtx());
+	}
+
+	// Private members
+	TickHandler _tickHandler; //< Handler called every period
+
+	static SysTick* _instance;
+};
+
+template<std::uint32_t TPeriodMs>
+SysTick<TPeriodMs>* SysTick<TPeriodMs>::_instance = nullptr;
+
+} // namespace device
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+#include <type_traits>
+
+#include "embxx/device/context.h"
+
+namespace driver {
+
+/**
+ * @brief Coarse timer service, driven by periodic tick device
+ * @details Ticks are only counted in the interrupt. Single event is posted
+ *  to the event loop, no matter how many ticks have elapsed since the last
+ *  one was handled, and then all subscribers are notified with the time
+ *  elapsed in milliseconds. Thanks to that, CPU load does not depend on the
+ *  event loop latency nor on the number of subscribers.
+ */
+template<typename TEventLoop, typename TTickDevice, typename TTickHandler,
+	std::size_t TMaxHandlers>
+class TickTimer
+{
+public:
+	using EventLoop = TEventLoop;
+	using TickDevice = TTickDevice;
+	using TickHandler = TTickHandler;
+
+	constexpr static auto MaxHandlers = TMaxHandlers;
+	constexpr static auto PeriodMs = TickDevice::PeriodMs;
+
+	static_assert(std::is_same_v<typename TickHandler::result_type, void>,
+		"Result type of callback must be 'void'");
+
+	/**
+	 * @brief Constructor
+	 * @details [long description]
+	 *
+	 * @param eventLoop [description]
+	 * @param tickDevice [description]
+	 */
+	TickTimer(EventLoop& eventLoop, TickDevice& tickDevice)
+		:	_eventLoop(eventLoop),
+			_tickDevice(tickDevice)
+	{
+		_tickDevice.setTickHandler(
+			[this]()
+			{
+				tick(InterruptCtx());
+			});
+	}
+
+	/**
+	 * @brief Registers handler, notified with elapsed milliseconds
+	 * @details Should be called before start
+	 *
+	 * @param handler [description]
+	 */
+	template<typename THandler>
+	void subscribe(THandler&& handler)
+	{
+		assert(!_tickDevice.isRunning());
+		assert(_handlersCount < MaxHandlers);
+
+		_handlers[_handlersCount++] = std::forward<THandler>(handler);
+	}
+
+	//! Starts ticking
+	void start()
+	{
+		_tickDevice.start();
+	}
+
+	//! Stops ticking
+	void stop()
+	{
+		_tickDevice.stop();
+	}
+
+	//! Returns milliseconds elapsed since start, as seen by the event loop
+	std::uint32_t now() const
+	{
+		return _nowMs;
+	}
+
+private:
+	using EventLoopCtx = embxx::device::context::EventLoop;
+	using InterruptCtx = embxx::device::context::Interrupt;
+
+	/**
+	 * @brief Tick device handler. Should be invoked from interrupt
+	 * @details [long description]
+	 *
+	 * @param  [description]
+	 */
+	void tick(InterruptCtx)
+	{
+		if(_pendingTicks.fetch_add(1) != 0)
+		{
+			return; // Event already posted, it will take this tick too
+		}
+
+		const auto postSuccess = _eventLoop.postInterruptCtx(
+			[this]()
+			{
+				notify(EventLoopCtx());
+			});
+		assert(postSuccess);
+		static_cast<void>(postSuccess);
+	}
+
+	void notify(EventLoopCtx)
+	{
+		// Take all ticks accumulated so far. Exchange is needed, because
+		//  the tick which comes in between would be lost otherwise
+		const auto ticks = _pendingTicks.exchange(0);
+
+		assert(ticks > 0);
+		const auto elapsedMs = ticks * PeriodMs;
+		_nowMs += elapsedMs;
+
+		for(std::size_t i = 0; i < _handlersCount; ++i)
+		{
+			_handlers[i](elapsedMs);
+		}
+	}
+
+	std::array<TickHandler, MaxHandlers> _handlers;
+	std::size_t _handlersCount = 0;
+
+	std::atomic<std::uint32_t> _pendingTicks{0};
+	std::uint32_t _nowMs = 0;
+
+	EventLoop& _eventLoop;
+	TickDevice& _tickDevice;
+};
+
+} // namespace driver
@@ -13,11 +13,20 @@
 #include "tivaware/inc/hw_nvic.h"
 #include "tivaware/inc/hw_memmap.h"
 #include "tivaware/driverlib/systick.h"
+#include "tivaware/driverlib/rom.h"
+#include "tivaware/driverlib/rom_map.h"
 
 void SysTickClear();
+bool SysTickIsEnabled();
 
 inline void
 SysTickClear()
 {
     HWREG(NVIC_ST_CURRENT) = 0; // dummy write to clear sys-tick and pending interrupt
 }
+
+inline bool
+SysTickIsEnabled()
+{
+    return (HWREG(NVIC_ST_CTRL) & NVIC_ST_CTRL_ENABLE) != 0;
+}
@@ -10,10 +10,13 @@ namespace app {
  * @details
  */
 Application::Application()
-	:	_blinker(_eventLoop)
+	:	_clock()
+		,_tickDevice()
+		,_tickTimer(_eventLoop, _tickDevice)
+		,_blinker(_eventLoop)
 		,_encoder0(_eventLoop)
 		,_encoder1(_eventLoop)
-		,_etherCAT(_eventLoop, _encoder0, _encoder1)
+		,_etherCAT(_eventLoop, _clock, _tickTimer, _encoder0, _encoder1)
 {
 	UARTprintf("[Application] initialized\n");
 
@@ -48,6 +51,9 @@ Application::start()
 {
 	UARTprintf("[Application] starting...\n");
 
+	// start commons
+	_tickTimer.start();
+
 	// start modules
 	_blinker.start();
 	_etherCAT.start();
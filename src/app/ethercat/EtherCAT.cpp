@@ -1,11 +1,19 @@
 #include "app/ethercat/EtherCAT.hpp"
 
+#include "tivaware/driverlib/interrupt.h"
 #include "tivaware/utils/uartstdio.h"
 
 #include "app/ethercat/abcc_drv/abcc.h"
 
 #include "embxx/error/ErrorStatus.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
 #include "util/driverlib/systick.hpp"
 
 extern "C" {
@@ -25,10 +33,67 @@ extern "C" {
 */
 #define APPL_WRITE_MAP_READ_ACCESS_DESC (ABP_APPD_DESCR_GET_ACCESS |          \
                                           ABP_APPD_DESCR_MAPPABLE_WRITE_PD)
+
+#define APPL_READ_MAP_WRITE_ACCESS_DESC (ABP_APPD_DESCR_GET_ACCESS |          \
+                                          ABP_APPD_DESCR_SET_ACCESS |          \
+                                          ABP_APPD_DESCR_MAPPABLE_READ_PD)
+
+//! Encoder status flags, bit numbers in the packed status field
+enum EncoderStatusFlag : UINT8
+{
+	EncoderStatusFrameError, //< Last capture failed, position is the last good one
+	EncoderStatusStale, //< Position is not of this cycle, its capture was late
+	EncoderStatusFlagCount
+};
+
+//! Status is published as a fixed width bit field, so the PD layout seen by
+//!  the master does not change, when new flags are added
+constexpr UINT8 EncoderStatusBits = 4;
+static_assert(EncoderStatusFlagCount <= EncoderStatusBits,
+	"Encoder status flags do not fit into the status field");
+constexpr UINT8 EncoderStatusDataType = ABP_BIT1 + EncoderStatusBits - 1;
+
+//! Smallest ABCC type holding positions of given resolution. There is no
+//!  24-bit type, so wider positions take 32 bits
+template<std::size_t TResolution>
+using EncoderPosition = std::conditional_t<(TResolution <= 8), UINT8,
+	std::conditional_t<(TResolution <= 16), UINT16, UINT32>>;
+
+template<std::size_t TResolution>
+constexpr UINT8 EncoderPositionDataType = (TResolution <= 8) ? ABP_UINT8
+	: (TResolution <= 16) ? ABP_UINT16 : ABP_UINT32;
+
+template<typename TEncoder>
 struct EncoderInputs
 {
-	BOOL frameError;
-	UINT32 position;
+	EncoderPosition<TEncoder::Resolution> position;
+	UINT8 status; //< EncoderStatusFlag bits
+};
+
+template<typename TEncoder>
+void setEncoderStatusFlag(EncoderInputs<TEncoder>& inputs,
+	EncoderStatusFlag flag, bool value)
+{
+	if(value)
+	{
+		inputs.status |= (1U << flag);
+	}
+	else
+	{
+		inputs.status &= ~(1U << flag);
+	}
+}
+
+//! SYNC period statistics of the last monitor window, in nanoseconds.
+//!  Histogram is an array ADI of its own, structure elements can not be arrays
+struct SyncMonitorValues
+{
+	UINT32 meanPeriod;
+	UINT32 minPeriod;
+	UINT32 maxPeriod;
+	UINT32 stdDev;
+	UINT32 count; //< Periods in the window
+	UINT32 histogram[app::ethercat::SyncMonitor::HistogramBins];
 };
 
 // struct EncoderSettings
@@ -37,22 +102,135 @@ struct EncoderInputs
 // 	UINT32 bitRate;
 // };
 
-EncoderInputs encoder0Inputs;
-EncoderInputs encoder1Inputs;
+EncoderInputs<app::encoders::Encoder0> encoder0Inputs;
+EncoderInputs<app::encoders::Encoder1> encoder1Inputs;
+SyncMonitorValues syncMonitorValues;
+
+//! Cycle latencies since start, in microseconds, see
+//!  EtherCAT::LatencyHistogram. Log2 histograms are array ADIs of their own,
+//!  the scalars of all phases make up a single structured ADI
+struct CycleLatencyValues
+{
+	struct Phase
+	{
+		UINT32 min;
+		UINT32 max;
+		UINT32 last;
+		UINT32 histogram[app::ethercat::EtherCAT::LatencyHistogramBins];
+	};
+
+	Phase total; //< From cycle start to PD frame transfer end
+	Phase captureStart; //< From cycle start
+	Phase capture;
+	Phase pdCopy; //< From capture end
+	Phase spiStart; //< From PD copy
+	Phase spiTransfer;
+};
+
+CycleLatencyValues cycleLatencyValues;
+
+//! Overruns since start, see EtherCAT::Overrun
+struct CycleOverrunValues
+{
+	UINT32 captureSkipped;
+	UINT32 captureLate;
+	UINT32 processLate;
+	UINT32 pdLate;
+	UINT32 slotMissed;
+};
+
+CycleOverrunValues cycleOverrunValues;
+
+//! Written by the master through read process data. A new sequence number
+//!  starts a probe, 0 means there is none
+struct LatencyProbeRequest
+{
+	UINT16 sequence;
+	UINT32 masterTime; //< Master's own, only echoed
+};
+
+//! Echo of the latest probe in write process data. Device times are raw clock
+//!  cycles, which wrap around, but their differences do not. Their frequency
+//!  is a get-only ADI of its own, so the whole response is mappable
+struct LatencyProbeResponse
+{
+	UINT16 sequence;
+	UINT32 masterTime;
+	UINT32 receivedTime; //< When the request was copied from read PD
+	UINT32 respondedTime; //< When the response was copied to write PD
+};
+
+LatencyProbeRequest latencyProbeRequest;
+LatencyProbeResponse latencyProbeResponse;
+UINT32 deviceClockFrequency = app::common::Clock::Frequency; //< In Hz
 
 // EncoderSettings encoder0Settings;
 // EncoderSettings encoder1Settings;
 
-static const AD_StructDataType encoder0InputsADIStruct[] =
+static constexpr AD_StructDataType encoder0InputsADIStruct[] =
+{
+	{ (char*)"Position", EncoderPositionDataType<app::encoders::Encoder0::Resolution>, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &encoder0Inputs.position, NULL } } },
+	{ (char*)"Status", EncoderStatusDataType, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &encoder0Inputs.status, NULL } } }
+};
+
+static constexpr AD_StructDataType encoder1InputsADIStruct[] =
+{
+	{ (char*)"Position", EncoderPositionDataType<app::encoders::Encoder1::Resolution>, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &encoder1Inputs.position, NULL } } },
+	{ (char*)"Status", EncoderStatusDataType, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &encoder1Inputs.status, NULL } } }
+};
+
+static constexpr AD_StructDataType syncMonitorADIStruct[] =
+{
+	{ (char*)"Mean period", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &syncMonitorValues.meanPeriod, NULL } } },
+	{ (char*)"Min period", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &syncMonitorValues.minPeriod, NULL } } },
+	{ (char*)"Max period", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &syncMonitorValues.maxPeriod, NULL } } },
+	{ (char*)"Std dev", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &syncMonitorValues.stdDev, NULL } } },
+	{ (char*)"Count", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &syncMonitorValues.count, NULL } } }
+};
+
+static constexpr AD_StructDataType cycleLatencyADIStruct[] =
+{
+	{ (char*)"Total min", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.total.min, NULL } } },
+	{ (char*)"Total max", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.total.max, NULL } } },
+	{ (char*)"Total last", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.total.last, NULL } } },
+	{ (char*)"Capture start min", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.captureStart.min, NULL } } },
+	{ (char*)"Capture start max", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.captureStart.max, NULL } } },
+	{ (char*)"Capture start last", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.captureStart.last, NULL } } },
+	{ (char*)"Capture min", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.capture.min, NULL } } },
+	{ (char*)"Capture max", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.capture.max, NULL } } },
+	{ (char*)"Capture last", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.capture.last, NULL } } },
+	{ (char*)"PD copy min", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.pdCopy.min, NULL } } },
+	{ (char*)"PD copy max", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.pdCopy.max, NULL } } },
+	{ (char*)"PD copy last", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.pdCopy.last, NULL } } },
+	{ (char*)"SPI start min", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.spiStart.min, NULL } } },
+	{ (char*)"SPI start max", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.spiStart.max, NULL } } },
+	{ (char*)"SPI start last", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.spiStart.last, NULL } } },
+	{ (char*)"SPI transfer min", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.spiTransfer.min, NULL } } },
+	{ (char*)"SPI transfer max", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.spiTransfer.max, NULL } } },
+	{ (char*)"SPI transfer last", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleLatencyValues.spiTransfer.last, NULL } } }
+};
+
+static constexpr AD_StructDataType cycleOverrunADIStruct[] =
 {
-	{ (char*)"Frame error", ABP_BOOL, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &encoder0Inputs.frameError, NULL } } },
-	{ (char*)"Position", ABP_UINT32, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &encoder0Inputs.position, NULL } } }
+	{ (char*)"Capture skipped", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleOverrunValues.captureSkipped, NULL } } },
+	{ (char*)"Capture late", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleOverrunValues.captureLate, NULL } } },
+	{ (char*)"Processing late", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleOverrunValues.processLate, NULL } } },
+	{ (char*)"PD late", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleOverrunValues.pdLate, NULL } } },
+	{ (char*)"Slot missed", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS, 0, { { &cycleOverrunValues.slotMissed, NULL } } }
 };
 
-static const AD_StructDataType encoder1InputsADIStruct[] =
+static constexpr AD_StructDataType latencyProbeRequestADIStruct[] =
 {
-	{ (char*)"Frame error", ABP_BOOL, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &encoder1Inputs.frameError, NULL } } },
-	{ (char*)"Position", ABP_UINT32, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &encoder1Inputs.position, NULL } } }
+	{ (char*)"Sequence", ABP_UINT16, 1, APPL_READ_MAP_WRITE_ACCESS_DESC, 0, { { &latencyProbeRequest.sequence, NULL } } },
+	{ (char*)"Master time", ABP_UINT32, 1, APPL_READ_MAP_WRITE_ACCESS_DESC, 0, { { &latencyProbeRequest.masterTime, NULL } } }
+};
+
+static constexpr AD_StructDataType latencyProbeResponseADIStruct[] =
+{
+	{ (char*)"Sequence", ABP_UINT16, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &latencyProbeResponse.sequence, NULL } } },
+	{ (char*)"Master time", ABP_UINT32, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &latencyProbeResponse.masterTime, NULL } } },
+	{ (char*)"Received time", ABP_UINT32, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &latencyProbeResponse.receivedTime, NULL } } },
+	{ (char*)"Responded time", ABP_UINT32, 1, APPL_WRITE_MAP_READ_ACCESS_DESC, 0, { { &latencyProbeResponse.respondedTime, NULL } } }
 };
 
 // static const AD_StructDataType encoder0SettingsADIStruct[] =
@@ -67,16 +245,30 @@ static const AD_StructDataType encoder1InputsADIStruct[] =
 // 	{ (char*)"Bit rate", ABP_UINT32, 1, ABP_APPD_DESCR_SET_ACCESS | ABP_APPD_DESCR_GET_ACCESS, 0, { { &encoder1Settings.bitRate, NULL } } }
 // };
 
-const AD_AdiEntryType APPL_asAdiEntryList[] =
+constexpr AD_AdiEntryType APPL_asAdiEntryList[] =
 {
-	{ 1, (char*)"Encoder0 Inputs", ABP_UINT8, 2, APPL_WRITE_MAP_READ_ACCESS_DESC,  { { NULL, NULL } }, encoder0InputsADIStruct, getEncoder0Inputs, NULL },
-	{ 2, (char*)"Encoder1 Inputs", ABP_UINT8, 2, APPL_WRITE_MAP_READ_ACCESS_DESC,  { { NULL, NULL } }, encoder1InputsADIStruct, getEncoder1Inputs, NULL }
-	// { 3, (char*)"Encoder0 Settings", ABP_UINT8, 2, ABP_APPD_DESCR_SET_ACCESS | ABP_APPD_DESCR_GET_ACCESS,  { { NULL, NULL } }, encoder0SettingsADIStruct, NULL, setEncoder0Settings },
-	// { 4, (char*)"Encoder1 Settings", ABP_UINT8, 2, ABP_APPD_DESCR_SET_ACCESS | ABP_APPD_DESCR_GET_ACCESS,  { { NULL, NULL } }, encoder1SettingsADIStruct, NULL, NULL }
+	{ 1, (char*)"Encoder0 Inputs", ABP_UINT8, 2, APPL_WRITE_MAP_READ_ACCESS_DESC,  { { NULL, NULL } }, encoder0InputsADIStruct, NULL, NULL },
+	{ 2, (char*)"Encoder1 Inputs", ABP_UINT8, 2, APPL_WRITE_MAP_READ_ACCESS_DESC,  { { NULL, NULL } }, encoder1InputsADIStruct, NULL, NULL },
+	{ 3, (char*)"Sync Monitor", ABP_UINT8, 5, ABP_APPD_DESCR_GET_ACCESS,  { { NULL, NULL } }, syncMonitorADIStruct, NULL, NULL },
+	{ 4, (char*)"Cycle Latency", ABP_UINT8, 18, ABP_APPD_DESCR_GET_ACCESS,  { { NULL, NULL } }, cycleLatencyADIStruct, NULL, NULL },
+	{ 5, (char*)"Cycle Overruns", ABP_UINT8, 5, ABP_APPD_DESCR_GET_ACCESS,  { { NULL, NULL } }, cycleOverrunADIStruct, NULL, NULL },
+	{ 6, (char*)"Latency Probe Request", ABP_UINT8, 2, APPL_READ_MAP_WRITE_ACCESS_DESC,  { { NULL, NULL } }, latencyProbeRequestADIStruct, NULL, NULL },
+	{ 7, (char*)"Latency Probe Response", ABP_UINT8, 4, APPL_WRITE_MAP_READ_ACCESS_DESC,  { { NULL, NULL } }, latencyProbeResponseADIStruct, NULL, NULL },
+	{ 8, (char*)"Sync Period Histogram", ABP_UINT32, app::ethercat::SyncMonitor::HistogramBins, ABP_APPD_DESCR_GET_ACCESS,  { { syncMonitorValues.histogram, NULL } }, NULL, NULL, NULL },
+	{ 9, (char*)"Cycle Latency Histogram", ABP_UINT32, app::ethercat::EtherCAT::LatencyHistogramBins, ABP_APPD_DESCR_GET_ACCESS,  { { cycleLatencyValues.total.histogram, NULL } }, NULL, NULL, NULL },
+	{ 10, (char*)"Capture Start Latency Histogram", ABP_UINT32, app::ethercat::EtherCAT::LatencyHistogramBins, ABP_APPD_DESCR_GET_ACCESS,  { { cycleLatencyValues.captureStart.histogram, NULL } }, NULL, NULL, NULL },
+	{ 11, (char*)"Capture Latency Histogram", ABP_UINT32, app::ethercat::EtherCAT::LatencyHistogramBins, ABP_APPD_DESCR_GET_ACCESS,  { { cycleLatencyValues.capture.histogram, NULL } }, NULL, NULL, NULL },
+	{ 12, (char*)"PD Copy Latency Histogram", ABP_UINT32, app::ethercat::EtherCAT::LatencyHistogramBins, ABP_APPD_DESCR_GET_ACCESS,  { { cycleLatencyValues.pdCopy.histogram, NULL } }, NULL, NULL, NULL },
+	{ 13, (char*)"SPI Start Latency Histogram", ABP_UINT32, app::ethercat::EtherCAT::LatencyHistogramBins, ABP_APPD_DESCR_GET_ACCESS,  { { cycleLatencyValues.spiStart.histogram, NULL } }, NULL, NULL, NULL },
+	{ 14, (char*)"SPI Transfer Latency Histogram", ABP_UINT32, app::ethercat::EtherCAT::LatencyHistogramBins, ABP_APPD_DESCR_GET_ACCESS,  { { cycleLatencyValues.spiTransfer.histogram, NULL } }, NULL, NULL, NULL },
+	{ 15, (char*)"Device Clock Frequency", ABP_UINT32, 1, ABP_APPD_DESCR_GET_ACCESS,  { { &deviceClockFrequency, NULL } }, NULL, NULL, NULL }
+	// { 16, (char*)"Encoder0 Settings", ABP_UINT8, 2, ABP_APPD_DESCR_SET_ACCESS | ABP_APPD_DESCR_GET_ACCESS,  { { NULL, NULL } }, encoder0SettingsADIStruct, NULL, setEncoder0Settings },
+	// { 17, (char*)"Encoder1 Settings", ABP_UINT8, 2, ABP_APPD_DESCR_SET_ACCESS | ABP_APPD_DESCR_GET_ACCESS,  { { NULL, NULL } }, encoder1SettingsADIStruct, NULL, NULL }
 };
 
 /*------------------------------------------------------------------------------
-** Map all adi:s in both directions
+** Map all adi:s in both directions. Positions go first, so they stay octet
+** aligned, and the status bit fields of both encoders share the last octet
 **------------------------------------------------------------------------------
 ** 1. AD instance | 2. Direction | 3. Num elements | 4. Start index |
 **------------------------------------------------------------------------------
@@ -84,27 +276,216 @@ const AD_AdiEntryType APPL_asAdiEntryList[] =
 const AD_DefaultMapType APPL_asAdObjDefaultMap[] =
 {
 	{ 1, PD_WRITE, 1, 0 },
-	{ 1, PD_WRITE, 1, 1 },
 	{ 2, PD_WRITE, 1, 0 },
+	{ 1, PD_WRITE, 1, 1 },
 	{ 2, PD_WRITE, 1, 1 },
 	{ AD_DEFAULT_MAP_END_ENTRY }
 };
 
+namespace {
+
+//! Size of ABCC data type in bits, the same as ABCC_GetDataTypeSizeInBits()
+constexpr std::size_t getDataTypeSizeInBits(UINT8 dataType)
+{
+	if(ABP_Is_PADx(dataType))
+	{
+		return dataType - ABP_PAD0;
+	}
+
+	if(ABP_Is_BITx(dataType))
+	{
+		return dataType - ABP_BIT1 + 1;
+	}
+
+	switch(dataType)
+	{
+	case ABP_UINT16:
+	case ABP_SINT16:
+	case ABP_BITS16:
+		return 16;
+
+	case ABP_UINT32:
+	case ABP_SINT32:
+	case ABP_BITS32:
+	case ABP_FLOAT:
+		return 32;
+
+	case ABP_UINT64:
+	case ABP_SINT64:
+		return 64;
+
+	default:
+		return 8;
+	}
+}
+
+//! Worst case process data usage of the ADI map in one direction
+struct PdFootprint
+{
+	std::size_t size = 0; //< Octets, when all mappable elements are mapped
+	std::size_t numMapEntries = 0; //< When each element is mapped separately
+	std::size_t numCopySteps = 0; //< Copy plan steps for such a map
+};
+
+//! Sums up all ADI elements, which are mappable with given descriptor bit.
+//! With remap the master can not map more than that, so the ABCC buffers
+//! do not have to be any larger
+constexpr PdFootprint getPdFootprint(UINT8 mappableDesc, bool writePd)
+{
+	PdFootprint footprint;
+	std::size_t sizeInBits = 0;
+
+	for(const auto& adiEntry : APPL_asAdiEntryList)
+	{
+		const auto hasCallback = writePd
+			? (adiEntry.pnGetAdiValue != nullptr)
+			: (adiEntry.pnSetAdiValue != nullptr);
+
+		for(std::size_t i = 0; i < adiEntry.bNumOfElements; ++i)
+		{
+			const auto desc = adiEntry.psStruct
+				? adiEntry.psStruct[i].bDesc
+				: adiEntry.bDesc;
+			if(!(desc & mappableDesc))
+			{
+				continue;
+			}
+
+			sizeInBits += adiEntry.psStruct
+				? getDataTypeSizeInBits(adiEntry.psStruct[i].bDataType)
+					* adiEntry.psStruct[i].iNumSubElem
+				: getDataTypeSizeInBits(adiEntry.bDataType);
+			footprint.numMapEntries += 1;
+			footprint.numCopySteps += hasCallback ? 2 : 1;
+		}
+	}
+
+	footprint.size = (sizeInBits + 7) / 8;
+	return footprint;
+}
+
+//! Checks, that structured ADIs are mappable only in directions all their
+//!  elements are, so mapping a whole ADI does not fail on some element
+constexpr bool areStructElementsMappable()
+{
+	constexpr UINT8 mappableDesc = ABP_APPD_DESCR_MAPPABLE_READ_PD
+		| ABP_APPD_DESCR_MAPPABLE_WRITE_PD;
+
+	for(const auto& adiEntry : APPL_asAdiEntryList)
+	{
+		if(!adiEntry.psStruct)
+		{
+			continue;
+		}
+
+		for(std::size_t i = 0; i < adiEntry.bNumOfElements; ++i)
+		{
+			if(adiEntry.bDesc & mappableDesc & ~adiEntry.psStruct[i].bDesc)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static_assert(areStructElementsMappable(),
+	"Structured ADI has elements, which can not be mapped with it");
+
+constexpr auto WritePdFootprint =
+	getPdFootprint(ABP_APPD_DESCR_MAPPABLE_WRITE_PD, true);
+constexpr auto ReadPdFootprint =
+	getPdFootprint(ABP_APPD_DESCR_MAPPABLE_READ_PD, false);
+
+// ABCC buffers are sized statically in abcc_drv_cfg.h and
+//  abcc_adapt_obj_app.h, so keep them in sync with the ADI map above.
+//  Process data size is required to be exact, because the SPI frame buffers
+//  scale with it, and there is no reason to waste SRAM for unused PD.
+static_assert(ABCC_CFG_MAX_PROCESS_DATA_SIZE
+		== std::max(WritePdFootprint.size, ReadPdFootprint.size),
+	"ABCC_CFG_MAX_PROCESS_DATA_SIZE does not match the ADI map");
+static_assert(AD_MAX_NUM_WRITE_MAP_ENTRIES >= WritePdFootprint.numMapEntries,
+	"AD_MAX_NUM_WRITE_MAP_ENTRIES is too small for the ADI map");
+static_assert(AD_MAX_NUM_READ_MAP_ENTRIES >= ReadPdFootprint.numMapEntries,
+	"AD_MAX_NUM_READ_MAP_ENTRIES is too small for the ADI map");
+static_assert(AD_MAX_NUM_WRITE_COPY_STEPS >= WritePdFootprint.numCopySteps,
+	"AD_MAX_NUM_WRITE_COPY_STEPS is too small for the ADI map");
+static_assert(AD_MAX_NUM_READ_COPY_STEPS >= ReadPdFootprint.numCopySteps,
+	"AD_MAX_NUM_READ_COPY_STEPS is too small for the ADI map");
+
+//! Octets of a PD frame in PROCESS_ACTIVE: message fragment and process data,
+//!  plus control, length, status, interrupt mask, CRC and padding fields
+constexpr std::uint32_t PdFrameOctets = 14 + ABCC_CFG_SPI_MSG_FRAG_LEN_CYCLIC
+	+ ABCC_CFG_MAX_PROCESS_DATA_SIZE;
+
+//! PD frames are not sent before PROCESS_ACTIVE, so the startup timing
+//!  estimates their transfer at the nominal SPI clock. Actual ones are
+//!  measured afterwards, also after a clock fallback
+constexpr std::uint32_t PdFrameTransferNs = static_cast<std::uint32_t>(
+	static_cast<std::uint64_t>(PdFrameOctets) * 8 * 1000000000ULL
+		/ ABCC_CFG_SPI_CLOCK_HZ);
+
+// Cycle schedule has to be doable within the timing the sync object reports
+//  to the master: the whole of it within the minimum cycle time, and inputs
+//  from their capture to the module within the input processing time
+using app::ethercat::CycleTask;
+constexpr auto& CycleSchedule = app::ethercat::EtherCAT::CycleSchedule;
+constexpr auto& CaptureSlot =
+	findScheduleSlot(CycleSchedule, CycleTask::CaptureInputs);
+constexpr auto& WriteSlot =
+	findScheduleSlot(CycleSchedule, CycleTask::WriteProcessData);
+
+static_assert(countScheduleSlots(CycleSchedule, CycleTask::CaptureInputs) == 1
+		&& countScheduleSlots(CycleSchedule, CycleTask::WriteProcessData) == 1,
+	"Cycle schedule has to capture and write inputs exactly once");
+static_assert(WriteSlot.offsetUs >= CaptureSlot.getEndUs(),
+	"Cycle schedule writes inputs before they are captured");
+static_assert(isScheduleOrdered(CycleSchedule),
+	"Cycle schedule slots are out of order or overlap");
+static_assert(getScheduleSpanUs(CycleSchedule) * 1000ULL
+		<= SYNC_IA_MIN_CYCLE_TIME_VALUE,
+	"Cycle schedule does not fit in the minimum cycle time");
+static_assert(static_cast<std::uint32_t>(
+			WriteSlot.getEndUs() - CaptureSlot.offsetUs) * 1000ULL
+		<= SYNC_IA_INPUT_PROCESSING_VALUE,
+	"Cycle schedule takes longer than the input processing time");
+
+} // namespace
+
 namespace app {
 namespace ethercat {
 
 EtherCAT* EtherCAT::_instance = nullptr;
 
 EtherCAT::EtherCAT(common::EventLoop& eventLoop,
+	common::Clock& clock,
+	common::TickTimer& tickTimer,
 	encoders::Encoder0& encoder0,
 	encoders::Encoder1& encoder1)
 	:	_eventLoop(eventLoop),
+		_clock(clock),
 		_encoder0(encoder0),
 		_encoder1(encoder1)
 {
+	markBootPhase(BootPhase::Start);
 	setupABCCHardware();
 	_instance = this;
 
+	_scheduleTimer.setTimeoutHandler(
+		[this]()
+		{
+			handleCycleSlot();
+		});
+
+	// ABCC timers (watchdog, startup timeout) are run in event loop context,
+	//  the same as ABCC_RunDriver(), so they never race with the driver
+	tickTimer.subscribe(
+		[this](std::uint32_t elapsedMs)
+		{
+			handleTick(elapsedMs);
+		});
+
 	UARTprintf("[EtherCAT] ready\n");
 	assert(_instance != nullptr);
 	assert(_state == State::Idle);
@@ -130,6 +511,7 @@ EtherCAT::setupABCCHardware()
 	assert(errorCode == ABCC_EC_NO_ERROR);
 	static_cast<void>(errorCode);
 
+	markBootPhase(BootPhase::HardwareReady);
 	UARTprintf("[EtherCAT] ABCC hardware setup success\n");
 }
 
@@ -169,16 +551,16 @@ EtherCAT::initDriver()
 		return;
 	}
 
-	constexpr auto StartupTimeMs = 0;
-	if(ABCC_StartDriver(StartupTimeMs) != ABCC_EC_NO_ERROR)
+	if(ABCC_StartDriver(StartupTimeoutMs) != ABCC_EC_NO_ERROR)
 	{
 		UARTprintf("[EtherCAT] module not answering\n");
-		_state = State::Error;
+		startRecovery();
 
 		return;
 	}
 
-    ABCC_HWReleaseReset();
+	ABCC_HWReleaseReset();
+	markBootPhase(BootPhase::ResetReleased);
 
 	UARTprintf("[EtherCAT] init success\n");
 	waitForCommunication();
@@ -191,37 +573,29 @@ EtherCAT::waitForCommunication()
 
 	_state = State::WaitForComm;
 
-	// Execute busy wait, to cyclically check the communication status
-	//  in order to detect moment, when ABCC is ready
-	_eventLoop.busyWait(
-		[this]()
-		{
-			assert(_state == State::WaitForComm);
-
-			const auto commState = ABCC_isReadyForCommunication();
-			if(commState == ABCC_READY_FOR_COMMUNICATION)
-			{
-				UARTprintf("[EtherCAT] module ready for communication\n");
-				run();
-
-				return true; // Ready for communication, so end busy wait
-			}
-			else if(commState == ABCC_COMMUNICATION_ERROR)
-			{
-				UARTprintf("[EtherCAT] module not answering\n");
-				_state = State::Error;
-
-				return true; // Error, so end busy wait
-			}
+	// No polling here. The first ABCC interrupt after reset tells that
+	//  module is ready and schedules driver run, which checks it. Startup
+	//  timeout is checked on every tick
+	UARTprintf("[EtherCAT] waiting for communication...\n");
+}
 
-			return false; // Not ready for communication, so don't end the wait
-		},
-		[]()
-		{
-			/* Busy wait ends, do nothing */
-		});
+void
+EtherCAT::checkCommunication()
+{
+	assert(_state == State::WaitForComm);
 
-	UARTprintf("[EtherCAT] waiting for communication...\n");
+	const auto commState = ABCC_isReadyForCommunication();
+	if(commState == ABCC_READY_FOR_COMMUNICATION)
+	{
+		markBootPhase(BootPhase::CommReady);
+		UARTprintf("[EtherCAT] module ready for communication\n");
+		run();
+	}
+	else if(commState == ABCC_COMMUNICATION_ERROR)
+	{
+		UARTprintf("[EtherCAT] module not answering\n");
+		startRecovery();
+	}
 }
 
 void
@@ -231,170 +605,1231 @@ EtherCAT::run()
 
 	_state = State::Run;
 
-	// Cyclically poll ABCC driver
-	_eventLoop.busyWait(
-		[this]()
-		{
-			// Module is active, keep communication with ABCC
-			if(const auto errorCode = ABCC_RunDriver();
-				errorCode != ABCC_EC_NO_ERROR)
-			{
-				UARTprintf("[EtherCAT] driver error during run, ec=%d\n",
-					errorCode);
-				_state = State::Error;
-			}
+	if(_recoveryAttempts > 0)
+	{
+		finishRecovery();
+	}
 
-			const auto endWait = (_state != State::Run);
-			return endWait;
-		},
-		[]()
-		{
-			UARTprintf("[EtherCAT] stopped\n");
-		});
+	// From now on ABCC driver is event driven. It is run on ABCC IRQ,
+	//  at the end of SPI transfer and after SYNC, so the CPU is free
+	//  (or sleeping) in between
+	scheduleDriverRun();
 
 	UARTprintf("[EtherCAT] running...\n");
 }
 
 void
-EtherCAT::captureInputs()
+EtherCAT::startRecovery()
 {
-	// captureEncoder0Inputs();
-	// captureEncoder1Inputs();
+	assert(_state != State::Idle);
+	assert(_state != State::Recovery);
+
+	// Shuts the driver down too, so no ABCC interrupt, SPI transfer nor
+	//  timeout comes until the driver is restarted. Encoders are not
+	//  touched, so their capture keeps running
+	ABCC_HWReset();
+	_anbState = ABP_ANB_STATE_SETUP;
+	_syncMonitor.restart();
+	_syncPll.reset();
+	_scheduleTimer.cancelWait(embxx::device::context::EventLoop());
+	_scheduleRunning = false;
+	_earlyCaptureStarted = false;
+	_calibrationCapturesLeft = 0;
+
+	// Capture held for the write slot would block all the next ones
+	if(std::exchange(_writeSlotPending, false)
+		&& _pendingReleases.fetch_sub(1) == 1)
+	{
+		processCapturedInputs();
+	}
 
-	/*
-	** Always update the ABCC with the latest write process data at the end of
-	** this function.
-	*/
-	ABCC_TriggerWrPdUpdate();
+	if(_recoveryAttempts == 0)
+	{
+		_recoveryStart = _clock.now();
+	}
+
+	// Shift is limited, so the delay does not overflow after many attempts
+	constexpr std::uint32_t MaxDelayShift = 16;
+	const auto delayShift = std::min(_recoveryAttempts, MaxDelayShift);
+	_recoveryDelayMs = std::min(RecoveryMinDelayMs << delayShift,
+		RecoveryMaxDelayMs);
+	++_recoveryAttempts;
+
+	_state = State::Recovery;
+
+	UARTprintf("[EtherCAT] recovering, attempt %u in %u ms\n",
+		_recoveryAttempts, _recoveryDelayMs);
 }
 
 void
-EtherCAT::captureEncoder0Inputs()
+EtherCAT::checkRecovery(std::uint32_t elapsedMs)
 {
-	// UARTprintf("[EtherCAT] capturing encoder0...\n");
+	assert(_state == State::Recovery);
 
-	encoders::Encoder0::Position position = 0;
-	ErrorCode ec;
-	_encoder0.captureInputs(position, ec);
-	if(embxx::error::ErrorStatus(ec))
+	// First tick may come right after the reset, so the delay is counted
+	//  down to zero first. This way module is held in reset at least that long
+	if(elapsedMs <= _recoveryDelayMs)
 	{
-		encoder0Inputs.frameError = true;
+		_recoveryDelayMs -= elapsedMs;
+		return;
 	}
-	else
+
+	// Module has been held in reset long enough, driver start releases it
+	_recoveryDelayMs = 0;
+	_state = State::Idle;
+	initDriver();
+}
+
+void
+EtherCAT::finishRecovery()
+{
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	// Timed by the cycle counter, so recovery taking longer than its wrap
+	//  around period is reported too short, what the attempts reveal
+	const auto recoveryUs = static_cast<std::uint32_t>(
+		duration_cast<microseconds>(_clock.now() - _recoveryStart).count());
+
+	++_recoveryCount;
+	_lastRecoveryUs = recoveryUs;
+	_maxRecoveryUs = std::max(_maxRecoveryUs, recoveryUs);
+
+	UARTprintf("[EtherCAT] recovered in %u us, %u attempt(s)"
+		" (recoveries: %u, max: %u us)\n",
+		recoveryUs, _recoveryAttempts, _recoveryCount, _maxRecoveryUs);
+
+	_recoveryAttempts = 0;
+}
+
+void
+EtherCAT::scheduleDriverRun()
+{
+	if(_driverRunPending.exchange(true))
+	{
+		return; // Already scheduled
+	}
+
+	const auto postSuccess = _eventLoop.post(
+		[this]()
+		{
+			runDriver();
+		});
+	assert(postSuccess);
+	static_cast<void>(postSuccess);
+}
+
+void
+EtherCAT::scheduleDriverRunInterruptCtx()
+{
+	if(_driverRunPending.exchange(true))
 	{
-		// inputs capture success
-		encoder0Inputs.position = position;
-		encoder0Inputs.frameError = false;
+		return; // Already scheduled
 	}
 
-	// UARTprintf("[EtherCAT] captured encoder0\n");
+	const auto postSuccess = _eventLoop.postInterruptCtx(
+		[this]()
+		{
+			runDriver();
+		});
+	assert(postSuccess);
+	static_cast<void>(postSuccess);
 }
 
 void
-EtherCAT::captureEncoder1Inputs()
+EtherCAT::runDriver()
 {
-	// UARTprintf("[EtherCAT] capturing encoder1...\n");
+	_driverRunPending = false;
 
-	encoders::Encoder1::Position position = 0;
-	ErrorCode ec;
-	_encoder1.captureInputs(position, ec);
-	if(embxx::error::ErrorStatus(ec))
+	if(_state == State::WaitForComm)
 	{
-		encoder1Inputs.frameError = true;
+		checkCommunication();
+		return;
 	}
-	else
+
+	if(_state != State::Run)
+	{
+		return; // Driver stopped in the meantime
+	}
+
+	// Module is active, keep communication with ABCC
+	if(const auto errorCode = ABCC_RunDriver();
+		errorCode != ABCC_EC_NO_ERROR)
 	{
-		// inputs capture success
-		encoder1Inputs.position = position;
-		encoder1Inputs.frameError = false;
+		UARTprintf("[EtherCAT] driver error during run, ec=%d\n",
+			errorCode);
+		startRecovery();
+
+		return;
 	}
 
-	// UARTprintf("[EtherCAT] captured encoder1\n");
+	// Continue without waiting for an event, if driver still has
+	//  something to do, e.g. message fragments to be sent
+	if(ABCC_IsRunDriverPending())
+	{
+		scheduleDriverRun();
+	}
 }
 
 void
-EtherCAT::handleSyncISR()
+EtherCAT::handleTick(std::uint32_t elapsedMs)
 {
-	/*
-	** This is the the start of the sync cycle. This point is as close to the
-	** SYNC Input Capture Point as this example gets. The measurement pin for
-	** input processing measurements is set here.
-	** Optimally this measurement should be done on the interrupt pin, but the
-	** GPIO needs to be toggled so that ABCC_GpioReset() can cause a sloping
-	** flank at the end point of input processing.
-	*/
-#if ABCC_CFG_SYNC_MEASUREMENT_IP
-	ABCC_GpioSet();
-#endif
+	if(_state == State::Idle || _state == State::Error)
+	{
+		return; // Driver is not started or was stopped
+	}
 
-	/*
-	** PORTING ALERT!
-	** Some applications require a PLL being locked to the sync signal before
-	** PROCESS_ACTIVE is entered. It is also possible to do measurement to verify
-	** the cycle time before allowing PROCESS_ACTIVE.
-	** Only ABP_APPSTAT_NO_ERROR will allow the ABCC to enter PROCESS_ACTIVE.
-	**
-	** In those cases this call must be relocated.
-	** In this example PROCESS_ACTIVE will be allowed as soon as the first sync
-	** interrupt appears.
-	*/
-	if(ABCC_GetAppStatus() != ABP_APPSTAT_NO_ERROR)
+	if(_state == State::Recovery)
 	{
-		if(ABCC_GetAppStatus() == ABP_APPSTAT_NOT_SYNCED)
-		{
-			ABCC_SetAppStatus(ABP_APPSTAT_NO_ERROR);
-		}
-		else
-		{
-			UARTprintf("[EtherCAT] returning\n");
-			return;
-		}
+		checkRecovery(elapsedMs);
+		return;
 	}
 
-	/*
-	** PORTING ALERT!
-	** The InputCaptureTime attribute in the sync object defines the time in
-	** nano seconds that shall be waited from this point before capturing the
-	** input data and send it to the ABCC.
-	** This means that a timer shall be started here, and when it expires
-	** triggerAdiSyncInputCapture() shall be called.
-	** In this example the input capture  time is ignored and the
-	** function is called directly (InputCaptureTime = 0).
-	*/
-	captureInputs();
-}
+	ABCC_RunTimerSystem(static_cast<INT16>(elapsedMs));
 
-} // namespace ethercat
-} // namespace app
+	// Startup timeout is only noticed, when communication state is checked
+	if(_state == State::WaitForComm)
+	{
+		checkCommunication();
+		return;
+	}
+
+	if(_state == State::Run && _anbState == ABP_ANB_STATE_PROCESS_ACTIVE)
+	{
+		checkFreeRunCapture(elapsedMs);
+	}
+
+	// Timeout handlers and free-run capture may have some work for the driver
+	if(_state == State::Run && ABCC_IsRunDriverPending())
+	{
+		scheduleDriverRun();
+	}
+
+	if(_state == State::Run)
+	{
+		updateDiagnostics(elapsedMs);
+		reportSchedStats(elapsedMs);
+	}
+}
 
 void
-ABCC_CbfSyncIsr(void)
+EtherCAT::LatencyStats::add(std::uint32_t latencyUs)
 {
-	const auto instance = app::ethercat::EtherCAT::_instance;
-	assert(instance != nullptr);
-	instance->handleSyncISR();
+	minUs = (count == 0) ? latencyUs : std::min(minUs, latencyUs);
+	maxUs = std::max(maxUs, latencyUs);
+	sumUs += latencyUs;
+	++count;
 }
 
 void
-ABCC_CbfEvent(UINT16)
+EtherCAT::SyncOffsetStats::add(std::int32_t offsetUs)
 {
-	/* do nothing */
+	minUs = (count == 0) ? offsetUs : std::min(minUs, offsetUs);
+	maxUs = std::max(maxUs, offsetUs);
+	sumUs += offsetUs;
+	++count;
 }
 
 void
-ABCC_CbfUserInitReq()
+EtherCAT::LatencyHistogram::add(std::uint32_t latencyUs)
 {
-	const auto moduleType = ABCC_ModuleType();
-	const auto networkType = ABCC_NetworkType();
+	// Bin is the bit width of the latency
+	const std::size_t bin = (latencyUs == 0)
+		? 0 : (32 - __builtin_clz(latencyUs));
+	++counts[std::min(bin, LatencyHistogramBins - 1)];
 
-	// Only ABCC B40 EtherCAT chip supported
-	assert(moduleType == ABP_MODULE_TYPE_ABCC_40);
-	assert(networkType == ABP_NW_TYPE_ECT);
+	if(count == 0 || latencyUs < minUs)
+	{
+		minUs = latencyUs;
+	}
+	maxUs = std::max(maxUs, latencyUs);
+	lastUs = latencyUs;
+	++count;
+}
+
+void
+EtherCAT::LatencyHistogram::print(const char* name) const
+{
+	UARTprintf("[EtherCAT] %s log2 [us]:", name);
+	for(const auto count : counts)
+	{
+		UARTprintf(" %u", count);
+	}
+	UARTprintf("\n");
+}
+
+void
+EtherCAT::LatencyStats::print(const char* name) const
+{
+	if(count == 0)
+	{
+		return;
+	}
+
+	UARTprintf("[EtherCAT] %s [us]: min %u, avg %u, max %u, jitter %u"
+		" (%u)\n", name, minUs, sumUs / count, maxUs, maxUs - minUs, count);
+}
+
+void
+EtherCAT::SyncOffsetStats::print(const char* name) const
+{
+	if(count == 0)
+	{
+		return;
+	}
+
+	UARTprintf("[EtherCAT] %s [us from SYNC]: min %d, avg %d, max %d,"
+		" jitter %u (%u)\n", name, minUs,
+		sumUs / static_cast<std::int32_t>(count), maxUs,
+		static_cast<std::uint32_t>(maxUs - minUs), count);
+}
+
+void
+EtherCAT::handleSpiSchedEvent(ABCC_SpiSchedEventType event)
+{
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	const auto now = _clock.now();
+
+	switch(event)
+	{
+	case ABCC_SPI_SCHED_MSG_QUEUED:
+		_msgQueuedTime = now;
+		break;
+
+	case ABCC_SPI_SCHED_MSG_SENT:
+		_msgStats.add(static_cast<std::uint32_t>(
+			duration_cast<microseconds>(now - _msgQueuedTime).count()));
+		break;
+
+	case ABCC_SPI_SCHED_PD_FRAME:
+	{
+		// Process data may be also written outside of the cycle, e.g. on
+		//  entering PROCESS_ACTIVE, what is then timed against the last one
+		const auto syncOffset = getSyncOffset(now);
+		_pdFrameStats.add(static_cast<std::int32_t>(
+			duration_cast<microseconds>(syncOffset).count()));
+		markCyclePhase(CyclePhase::SpiStart, now);
+
+		if(std::exchange(_pdDeadlinePending, false)
+			&& syncOffset > SyncOffset(_cycleBudget))
+		{
+			countOverrun(Overrun::PdLate);
+		}
+		break;
+	}
+	}
+}
+
+void
+EtherCAT::reportSchedStats(std::uint32_t elapsedMs)
+{
+	_schedStatsElapsedMs += elapsedMs;
+	if(_schedStatsElapsedMs < SchedStatsReportMs)
+	{
+		return;
+	}
+
+	_schedStatsElapsedMs = 0;
+
+	// Pipeline stages: cycle start -> capture -> processing -> PD frame.
+	//  Capture and PD frame are timed from SYNC, even when ahead of it
+	_captureStartStats.print("capture started");
+	_captureStats.print("inputs captured");
+	_processStats.print("inputs processed after capture");
+	_pdFrameStats.print("PD frame");
+	_msgStats.print("message latency");
+
+	_syncMonitor.print();
+	_syncPll.print();
+
+	constexpr std::array<const char*, CyclePhaseCount> histogramNames{{
+		"cycle total",
+		"capture start",
+		"capture",
+		"PD copy",
+		"SPI start",
+		"SPI transfer"
+	}};
+
+	for(std::size_t i = 0; i < CyclePhaseCount; ++i)
+	{
+		_cycleHistograms[i].print(histogramNames[i]);
+	}
+
+	// Totals are printed, only if there were new ones since the last report
+	std::array<std::uint32_t, OverrunCount> overruns;
+	for(std::size_t i = 0; i < OverrunCount; ++i)
+	{
+		overruns[i] = _overruns[i];
+	}
+
+	if(overruns != _reportedOverruns)
+	{
+		_reportedOverruns = overruns;
+		UARTprintf("[EtherCAT] overruns: capture skipped %u, capture late %u,"
+			" processing late %u, PD late %u, slot missed %u\n",
+			overruns[0], overruns[1], overruns[2], overruns[3], overruns[4]);
+	}
+
+	_captureStartStats = SyncOffsetStats();
+	_captureStats = SyncOffsetStats();
+	_processStats = LatencyStats();
+	_pdFrameStats = SyncOffsetStats();
+	_msgStats = LatencyStats();
+}
+
+void
+EtherCAT::updateDiagnostics(std::uint32_t elapsedMs)
+{
+	_syncMonitor.update();
+
+	_diagnosticsElapsedMs += elapsedMs;
+	if(_diagnosticsElapsedMs < DiagnosticsWindowMs)
+	{
+		return;
+	}
+
+	_diagnosticsElapsedMs = 0;
+
+	// Deviations are counted against the cycle time set by the master
+	const auto& stats = _syncMonitor.finishWindow(SYNC_GetCycleTime());
+	syncMonitorValues.meanPeriod = stats.meanNs;
+	syncMonitorValues.minPeriod = stats.minNs;
+	syncMonitorValues.maxPeriod = stats.maxNs;
+	syncMonitorValues.stdDev = stats.stdDevNs;
+	syncMonitorValues.count = stats.count;
+	std::copy(stats.histogram.begin(), stats.histogram.end(),
+		std::begin(syncMonitorValues.histogram));
+
+	// Histograms are never restarted, so the rare tail is not lost. They are
+	//  updated in interrupts meanwhile, but each value is copied at once
+	CycleLatencyValues::Phase* const phaseValues[] = {
+		&cycleLatencyValues.total,
+		&cycleLatencyValues.captureStart,
+		&cycleLatencyValues.capture,
+		&cycleLatencyValues.pdCopy,
+		&cycleLatencyValues.spiStart,
+		&cycleLatencyValues.spiTransfer
+	};
+	static_assert(std::size(phaseValues) == CyclePhaseCount,
+		"Cycle latency ADIs do not match cycle phases");
+
+	for(std::size_t i = 0; i < CyclePhaseCount; ++i)
+	{
+		const auto& histogram = _cycleHistograms[i];
+		phaseValues[i]->min = histogram.minUs;
+		phaseValues[i]->max = histogram.maxUs;
+		phaseValues[i]->last = histogram.lastUs;
+		std::copy(histogram.counts.begin(), histogram.counts.end(),
+			std::begin(phaseValues[i]->histogram));
+	}
+
+	UINT32* const overrunValues[] = {
+		&cycleOverrunValues.captureSkipped,
+		&cycleOverrunValues.captureLate,
+		&cycleOverrunValues.processLate,
+		&cycleOverrunValues.pdLate,
+		&cycleOverrunValues.slotMissed
+	};
+	static_assert(std::size(overrunValues) == OverrunCount,
+		"Cycle overrun ADI does not match overruns");
+
+	for(std::size_t i = 0; i < OverrunCount; ++i)
+	{
+		*overrunValues[i] = _overruns[i];
+	}
+
+	if(const auto inputPathMax = _inputPathMax; inputPathMax > 0)
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::nanoseconds;
+
+		updateSyncTiming(static_cast<std::uint32_t>(duration_cast<nanoseconds>(
+			common::Clock::duration(inputPathMax)).count()));
+	}
+}
+
+void
+EtherCAT::markCyclePhase(CyclePhase phase, common::Clock::time_point timestamp)
+{
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	const auto index = static_cast<std::size_t>(phase);
+	assert(index < CyclePhaseCount);
+
+	// Phases are marked from interrupts of different priorities and from the
+	//  event loop, so the phase state is updated with interrupts disabled.
+	//  They may be disabled already, e.g. in the driver's critical section
+	const auto wereDisabled = IntMasterDisable();
+
+	// Start always begins a new cycle, e.g. when the last one never got to
+	//  the PD frame
+	const auto inOrder = (phase == CyclePhase::Start)
+		|| (index == _nextCyclePhase);
+	if(inOrder)
+	{
+		_cycleTimestamps[index] = timestamp;
+		_nextCyclePhase = index + 1;
+	}
+
+	const auto cycleDone = inOrder && (phase == CyclePhase::SpiEnd);
+	std::array<common::Clock::time_point, CyclePhaseCount> timestamps{};
+	if(cycleDone)
+	{
+		timestamps = _cycleTimestamps;
+		_nextCyclePhase = CyclePhaseCount; // Wait for the next start
+
+		const auto inputPath = (timestamp - timestamps[0]).count();
+		if(inputPath > _inputPathMax)
+		{
+			_inputPathMax = inputPath;
+		}
+	}
+
+	if(!wereDisabled)
+	{
+		IntMasterEnable();
+	}
+
+	if(!cycleDone)
+	{
+		return;
+	}
+
+	// Histograms are only added to here, by the last phase of a cycle. The
+	//  next cycle gets to it long after, so they need no lock
+	const auto toUs = [](auto duration)
+	{
+		return static_cast<std::uint32_t>(
+			duration_cast<microseconds>(duration).count());
+	};
+
+	_cycleHistograms[0].add(toUs(timestamp - timestamps[0]));
+	for(std::size_t i = 1; i < CyclePhaseCount; ++i)
+	{
+		_cycleHistograms[i].add(toUs(timestamps[i] - timestamps[i - 1]));
+	}
+}
+
+void
+EtherCAT::configureSyncMode()
+{
+	constexpr std::array<const char*, SyncModeCount> modeStrings{{
+		"free-run",
+		"SM-synchronous",
+		"DC-synchronous"
+	}};
+
+	if(SYNC_GetMode() == SYNC_MODE_SYNCHRONOUS)
+	{
+		_syncMode = SyncMode::DcSynchronous;
+	}
+	else if(ReadPdFootprint.size > 0)
+	{
+		_syncMode = SyncMode::SmSynchronous;
+	}
+	else
+	{
+		// Nothing can be mapped as outputs, so there is no SM2 event to follow
+		_syncMode = SyncMode::FreeRun;
+	}
+
+	_readPdReceived = false;
+	_freeRunElapsedMs = 0;
+	_probeSequence = 0; // Master starts the probes over in the new session
+	_probePending = false;
+
+	UARTprintf("[EtherCAT] sync mode: %s\n",
+		modeStrings[static_cast<std::size_t>(_syncMode)]);
+}
+
+void
+EtherCAT::handleNewReadPd()
+{
+	if(_syncMode != SyncMode::SmSynchronous)
+	{
+		return;
+	}
+
+	_readPdReceived = true;
+
+	if(!captureInputs(_clock.now(), false))
+	{
+		resendStaleInputs();
+	}
+}
+
+void
+EtherCAT::handleProbeRequest(common::Clock::time_point receivedTime)
+{
+	const auto sequence = latencyProbeRequest.sequence;
+	if(sequence == 0 || sequence == _probeSequence)
+	{
+		return; // No probe, or it is answered already
+	}
+
+	_probeSequence = sequence;
+	_probeMasterTime = latencyProbeRequest.masterTime;
+	_probeReceivedTime = receivedTime;
+	_probePending = true;
+}
+
+void
+EtherCAT::updateProbeResponse(common::Clock::time_point respondedTime)
+{
+	if(!_probePending)
+	{
+		return;
+	}
+
+	_probePending = false;
+	latencyProbeResponse.sequence = _probeSequence;
+	latencyProbeResponse.masterTime = _probeMasterTime;
+	latencyProbeResponse.receivedTime =
+		_probeReceivedTime.time_since_epoch().count();
+	latencyProbeResponse.respondedTime =
+		respondedTime.time_since_epoch().count();
+}
+
+void
+EtherCAT::checkFreeRunCapture(std::uint32_t elapsedMs)
+{
+	if(_syncMode == SyncMode::DcSynchronous)
+	{
+		return;
+	}
+
+	_freeRunElapsedMs += elapsedMs;
+	if(_freeRunElapsedMs < FreeRunCycleMs)
+	{
+		return;
+	}
+
+	_freeRunElapsedMs = 0;
+
+	const auto readPdReceived = std::exchange(_readPdReceived, false);
+	if(_syncMode == SyncMode::SmSynchronous && readPdReceived)
+	{
+		return; // Bus cycle is faster, so it paces the capture
+	}
+
+	if(!captureInputs(_clock.now(), false))
+	{
+		resendStaleInputs();
+	}
+}
+
+void
+EtherCAT::handleSyncISR()
+{
+	/*
+	** This is the the start of the sync cycle. This point is as close to the
+	** SYNC Input Capture Point as this example gets. The measurement pin for
+	** input processing measurements is set here.
+	** Optimally this measurement should be done on the interrupt pin, but the
+	** GPIO needs to be toggled so that ABCC_GpioReset() can cause a sloping
+	** flank at the end point of input processing.
+	*/
+	const auto syncTime = _clock.now();
+	_syncMonitor.recordEdge(syncTime);
+	_syncPll.trackEdge(syncTime);
+
+#if ABCC_CFG_SYNC_MEASUREMENT_IP
+	ABCC_GpioSet();
+#endif
+
+	// Application status only changes until the first SYNC is accepted,
+	//  what is not time critical, so it is left to the event loop
+	const auto appStatus = ABCC_GetAppStatus();
+	if(appStatus != ABP_APPSTAT_NO_ERROR && !_syncDeferredPending)
+	{
+		_syncDeferredPending = true;
+
+		const auto postSuccess = _eventLoop.postInterruptCtx(
+			[this]()
+			{
+				handleSyncDeferred();
+			});
+		assert(postSuccess);
+		static_cast<void>(postSuccess);
+	}
+
+	if(appStatus != ABP_APPSTAT_NO_ERROR
+		&& appStatus != ABP_APPSTAT_NOT_SYNCED)
+	{
+		return; // Sync configuration is wrong
+	}
+
+	if(_syncMode != SyncMode::DcSynchronous)
+	{
+		return; // Inputs are captured on another event
+	}
+
+	/*
+	** PORTING ALERT!
+	** The InputCaptureTime attribute in the sync object defines the time in
+	** nano seconds that shall be waited from this point before capturing the
+	** input data and send it to the ABCC.
+	** This means that a timer shall be started here, and when it expires
+	** triggerAdiSyncInputCapture() shall be called.
+	** In this example the input capture  time is ignored and the
+	** function is called directly (InputCaptureTime = 0).
+	**
+	** Once the PLL is locked, inputs of the cycle were captured ahead of this
+	** edge by the cycle schedule. The edge only captures, when that did not
+	** happen, e.g. right after the lock was lost.
+	*/
+	if(!std::exchange(_earlyCaptureStarted, false)
+		&& !captureInputs(syncTime, false))
+	{
+		scheduleStaleResendInterruptCtx();
+	}
+
+	if(_syncPll.isLocked() && !_scheduleRunning)
+	{
+		startCycleSchedule();
+	}
+}
+
+void
+EtherCAT::startCycleSchedule()
+{
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	constexpr auto scheduleSpan = duration_cast<common::Clock::duration>(
+		microseconds(getScheduleSpanUs(CycleSchedule)));
+
+	// Cycles of the schedule must not overlap, even if the master chose a
+	//  shorter cycle than the minimum
+	if(_syncPll.getPeriod() <= scheduleSpan)
+	{
+		return;
+	}
+
+	_scheduleEdge = _syncPll.getNextEdge();
+	_scheduleSlot = 0;
+	_scheduleRunning = true;
+
+	armCycleSlot();
+}
+
+void
+EtherCAT::armCycleSlot()
+{
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+	using InterruptCtx = embxx::device::context::Interrupt;
+
+	if(_scheduleSlot == CycleSchedule.size())
+	{
+		// Cycle is done, so go on with the next one, as long as the PLL
+		//  follows SYNC. Otherwise the edge captures again
+		if(!_syncPll.isLocked())
+		{
+			stopCycleSchedule();
+			return;
+		}
+
+		_scheduleEdge = _syncPll.getNextEdge();
+		_scheduleSlot = 0;
+	}
+
+	// Offsets ahead of SYNC wrap around, the same as the clock does
+	const auto& slot = CycleSchedule[_scheduleSlot];
+	const auto slotTime = _scheduleEdge
+		+ duration_cast<common::Clock::duration>(microseconds(slot.offsetUs));
+
+	// Unsigned difference, so the slot time already passed looks like a wait
+	//  longer than the period, e.g. when SYNC came too late to be tracked
+	const auto wait = slotTime - _clock.now();
+	if(wait.count() == 0 || wait > _syncPll.getPeriod())
+	{
+		countOverrun(Overrun::SlotMissed);
+		stopCycleSchedule();
+		return; // Restarted by the next SYNC
+	}
+
+	_scheduleTimer.startWait(wait, InterruptCtx());
+}
+
+void
+EtherCAT::stopCycleSchedule()
+{
+	_scheduleRunning = false;
+
+	// Held capture would block all the next ones, so it goes out right away
+	if(std::exchange(_writeSlotPending, false))
+	{
+		releaseCapturedInputs();
+	}
+}
+
+void
+EtherCAT::handleCycleSlot()
+{
+	const auto& slot = CycleSchedule[_scheduleSlot++];
+	switch(slot.task)
+	{
+	case CycleTask::CaptureInputs:
+		_earlyCaptureStarted = true;
+		if(!captureInputs(_clock.now(), true))
+		{
+			scheduleStaleResendInterruptCtx();
+		}
+		break;
+
+	case CycleTask::WriteProcessData:
+		if(std::exchange(_writeSlotPending, false))
+		{
+			releaseCapturedInputs();
+		}
+		break;
+
+	case CycleTask::ServiceMessages:
+		// Driver runs on other events too, this only makes sure messages
+		//  queued during the cycle go out while there is no PD transfer
+		scheduleDriverRunInterruptCtx();
+		break;
+	}
+
+	armCycleSlot();
+}
+
+void
+EtherCAT::handleSyncDeferred()
+{
+	_syncDeferredPending = false;
+
+	/*
+	** PORTING ALERT!
+	** Some applications require a PLL being locked to the sync signal before
+	** PROCESS_ACTIVE is entered. It is also possible to do measurement to verify
+	** the cycle time before allowing PROCESS_ACTIVE.
+	** Only ABP_APPSTAT_NO_ERROR will allow the ABCC to enter PROCESS_ACTIVE.
+	**
+	** In those cases this call must be relocated.
+	** In this example PROCESS_ACTIVE will be allowed as soon as the first sync
+	** interrupt appears.
+	*/
+	const auto appStatus = ABCC_GetAppStatus();
+	if(appStatus == ABP_APPSTAT_NOT_SYNCED)
+	{
+		ABCC_SetAppStatus(ABP_APPSTAT_NO_ERROR);
+	}
+	else if(appStatus != ABP_APPSTAT_NO_ERROR)
+	{
+		UARTprintf("[EtherCAT] SYNC ignored, app status %u\n",
+			static_cast<unsigned>(appStatus));
+	}
+}
+
+bool
+EtherCAT::captureInputs(common::Clock::time_point cycleStartTime,
+	bool scheduled)
+{
+	if(_captureInProgress)
+	{
+		// Cycle is shorter than the capture. Previous inputs are still on
+		//  their way, so they are not overwritten
+		countOverrun(Overrun::CaptureSkipped);
+		return false;
+	}
+
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	constexpr auto captureSlotBudget =
+		duration_cast<common::Clock::duration>(microseconds(
+			findScheduleSlot(CycleSchedule, CycleTask::CaptureInputs).budgetUs));
+
+	_captureInProgress = true;
+	_cycleStartTime = cycleStartTime;
+	_cycleSyncTime = scheduled ? _scheduleEdge : cycleStartTime;
+	_cycleBudget = getCyclePeriod();
+	_captureBudget = scheduled ? captureSlotBudget : _cycleBudget;
+	markCyclePhase(CyclePhase::Start, cycleStartTime);
+
+	const auto captureStartTime = _clock.now();
+	markCyclePhase(CyclePhase::CaptureStart, captureStartTime);
+	_captureStartStats.add(static_cast<std::int32_t>(
+		duration_cast<microseconds>(getSyncOffset(captureStartTime)).count()));
+	_pendingEncoders = 2;
+	_pendingReleases = scheduled ? 2 : 1;
+	_writeSlotPending = scheduled;
+
+	// Both encoders are read in parallel, each by its own SSI
+	_encoder0.asyncCaptureInputsInterruptCtx(&_encoder0Capture.position,
+		[this](ErrorCode errorCode)
+		{
+			handleEncoderCaptured(_encoder0Capture, errorCode);
+		});
+	_encoder1.asyncCaptureInputsInterruptCtx(&_encoder1Capture.position,
+		[this](ErrorCode errorCode)
+		{
+			handleEncoderCaptured(_encoder1Capture, errorCode);
+		});
+
+	return true;
+}
+
+void
+EtherCAT::handleEncoderCaptured(EncoderCapture& capture, ErrorCode errorCode)
+{
+	// Position is only stored by the encoder on success
+	capture.error = embxx::error::ErrorStatus(errorCode);
+
+	if(_pendingEncoders.fetch_sub(1) != 1)
+	{
+		return; // The other encoder is still being read
+	}
+
+	_capturedTime = _clock.now();
+	markCyclePhase(CyclePhase::CaptureEnd, _capturedTime);
+
+	if(_capturedTime - _cycleStartTime > _captureBudget)
+	{
+		countOverrun(Overrun::CaptureLate);
+	}
+
+	releaseCapturedInputs();
+}
+
+void
+EtherCAT::releaseCapturedInputs()
+{
+	if(_pendingReleases.fetch_sub(1) != 1)
+	{
+		return; // Still captured or waiting for the write slot
+	}
+
+	// Driver runs in the event loop, so the transfer is started from there,
+	//  as the very next thing
+	const auto postSuccess = _eventLoop.postInterruptCtx(
+		[this]()
+		{
+			processCapturedInputs();
+		});
+	assert(postSuccess);
+	static_cast<void>(postSuccess);
+}
+
+void
+EtherCAT::processCapturedInputs()
+{
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	const auto now = _clock.now();
+
+	// Late inputs are still the latest ones, so they are sent anyway, but
+	//  flagged, so the master knows they are not of the current cycle
+	const auto late = (now - _cycleStartTime > _cycleBudget);
+	if(late)
+	{
+		countOverrun(Overrun::ProcessLate);
+	}
+
+	// ADIs are published here, not in the interrupt, so the driver never
+	//  copies the position and the status of different captures
+	using Encoder0Position = decltype(encoder0Inputs.position);
+	using Encoder1Position = decltype(encoder1Inputs.position);
+	encoder0Inputs.position =
+		static_cast<Encoder0Position>(_encoder0Capture.position);
+	setEncoderStatusFlag(encoder0Inputs, EncoderStatusFrameError,
+		_encoder0Capture.error);
+	setEncoderStatusFlag(encoder0Inputs, EncoderStatusStale, late);
+	encoder1Inputs.position =
+		static_cast<Encoder1Position>(_encoder1Capture.position);
+	setEncoderStatusFlag(encoder1Inputs, EncoderStatusFrameError,
+		_encoder1Capture.error);
+	setEncoderStatusFlag(encoder1Inputs, EncoderStatusStale, late);
+
+	// Statistics are optional, so skipped, when already behind
+	if(!late)
+	{
+		_captureStats.add(static_cast<std::int32_t>(
+			duration_cast<microseconds>(getSyncOffset(_capturedTime)).count()));
+		_processStats.add(static_cast<std::uint32_t>(
+			duration_cast<microseconds>(now - _capturedTime).count()));
+	}
+
+	// From now on the next capture may overwrite the stored results
+	_captureInProgress = false;
+
+	if(_calibrationCapturesLeft > 0)
+	{
+		continueTimingCalibration(now - _cycleStartTime);
+		return; // No process data until the user init is complete
+	}
+
+	/*
+	** Always update the ABCC with the latest write process data at the end of
+	** the capture. Transfer starts right away, or at the end of the ongoing
+	** one, when its DMA completes.
+	*/
+	if(_state == State::Run)
+	{
+		_pdDeadlinePending = !late;
+		ABCC_TriggerWrPdUpdate();
+		runDriver();
+	}
+}
+
+void
+EtherCAT::scheduleStaleResendInterruptCtx()
+{
+	if(_staleResendPending)
+	{
+		return; // Already scheduled
+	}
+
+	_staleResendPending = true;
+
+	const auto postSuccess = _eventLoop.postInterruptCtx(
+		[this]()
+		{
+			resendStaleInputs();
+		});
+	assert(postSuccess);
+	static_cast<void>(postSuccess);
+}
+
+void
+EtherCAT::resendStaleInputs()
+{
+	_staleResendPending = false;
+
+	if(_state != State::Run)
+	{
+		return;
+	}
+
+	// Positions are left as they are, the capture in progress publishes new
+	//  ones once it is done
+	setEncoderStatusFlag(encoder0Inputs, EncoderStatusStale, true);
+	setEncoderStatusFlag(encoder1Inputs, EncoderStatusStale, true);
+
+	// May be called from a driver callback (SM-synchronous capture), so the
+	//  driver is not run from here
+	ABCC_TriggerWrPdUpdate();
+	scheduleDriverRun();
+}
+
+common::Clock::duration
+EtherCAT::getCyclePeriod() const
+{
+	using std::chrono::duration_cast;
+	using std::chrono::milliseconds;
+	using std::chrono::nanoseconds;
+
+	if(_syncMode == SyncMode::DcSynchronous)
+	{
+		if(const auto period = _syncPll.getPeriod(); period.count() > 0)
+		{
+			return period;
+		}
+
+		// PLL has not acquired the period yet, so the one set by the master
+		if(const auto cycleTimeNs = SYNC_GetCycleTime(); cycleTimeNs > 0)
+		{
+			return duration_cast<common::Clock::duration>(
+				nanoseconds(cycleTimeNs));
+		}
+	}
+
+	return duration_cast<common::Clock::duration>(
+		milliseconds(FreeRunCycleMs));
+}
+
+void
+EtherCAT::countOverrun(Overrun overrun)
+{
+	const auto index = static_cast<std::size_t>(overrun);
+	assert(index < OverrunCount);
+
+	_overruns[index].fetch_add(1);
+}
+
+EtherCAT::SyncOffset
+EtherCAT::getSyncOffset(common::Clock::time_point time) const
+{
+	// Clock difference wraps around, what is undone by the signed duration
+	return SyncOffset(static_cast<SyncOffset::rep>(
+		(time - _cycleSyncTime).count()));
+}
+
+void
+EtherCAT::startTimingCalibration()
+{
+	_calibrationCapturesLeft = TimingCalibrationCaptures;
+	_calibrationMax = common::Clock::duration::zero();
+
+	// Capture still in progress, e.g. from before a recovery, is timed as
+	//  the first one instead
+	captureInputs(_clock.now(), false);
+}
+
+void
+EtherCAT::continueTimingCalibration(common::Clock::duration inputPath)
+{
+	using std::chrono::duration_cast;
+	using std::chrono::nanoseconds;
+
+	if(_state != State::Run)
+	{
+		_calibrationCapturesLeft = 0;
+		return; // Module is being recovered, user init comes again
+	}
+
+	_calibrationMax = std::max(_calibrationMax, inputPath);
+	if(--_calibrationCapturesLeft > 0)
+	{
+		captureInputs(_clock.now(), false);
+		return;
+	}
+
+	updateSyncTiming(static_cast<std::uint32_t>(
+		duration_cast<nanoseconds>(_calibrationMax).count()) + PdFrameTransferNs);
+
+	ABCC_UserInitComplete();
+}
+
+void
+EtherCAT::updateSyncTiming(std::uint32_t inputProcessingNs)
+{
+	const auto publishedNs =
+		inputProcessingNs + inputProcessingNs / 100 * TimingMarginPercent;
+	if(publishedNs <= _publishedInputProcessingNs)
+	{
+		return;
+	}
+
+	_publishedInputProcessingNs = publishedNs;
+
+	// Output side is not measured, so its delay stays as configured. The
+	//  cycle schedule has to fit in the cycle too
+	constexpr auto scheduleSpanNs = getScheduleSpanUs(CycleSchedule) * 1000;
+	const auto minCycleNs = std::max<std::uint32_t>(
+		RDPDI_TO_SYNC_DELAY + publishedNs, scheduleSpanNs);
+
+	SYNC_SetInputProcessingTime(publishedNs);
+	SYNC_SetMinCycleTime(minCycleNs);
+
+	UARTprintf("[EtherCAT] sync timing: input processing %u ns,"
+		" min cycle %u ns\n", publishedNs, minCycleNs);
+}
+
+bool
+EtherCAT::markBootPhase(BootPhase phase)
+{
+	const auto index = static_cast<std::size_t>(phase);
+	assert(index < BootPhaseCount);
+
+	const auto mask = (1U << index);
+	if(_bootPhasesReached & mask)
+	{
+		return false; // Only the first time counts, e.g. after IDLE/PROCESS_ACTIVE
+	}
+
+	_bootTimestamps[index] = _clock.now();
+	_bootPhasesReached |= mask;
+	return true;
+}
+
+void
+EtherCAT::printBootReport()
+{
+	constexpr std::array<const char*, BootPhaseCount> phaseStrings{{
+		"start",
+		"hardware ready",
+		"reset released",
+		"comm ready",
+		"user init",
+		"NW_INIT",
+		"WAIT_PROCESS",
+		"PROCESS_ACTIVE"
+	}};
+
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	// Phases are timed by the cycle counter, so each of them has to be
+	//  shorter than its wrap around period, what holds when master is up
+	const auto start = _bootTimestamps[0];
+	auto previous = start;
+
+	UARTprintf("[EtherCAT] boot phases [us]:\n");
+	for(std::size_t i = 1; i < BootPhaseCount; ++i)
+	{
+		if(!(_bootPhasesReached & (1U << i)))
+		{
+			continue; // Module went through this state too fast to notice
+		}
+
+		const auto timestamp = _bootTimestamps[i];
+		const auto phaseUs = static_cast<std::uint32_t>(
+			duration_cast<microseconds>(timestamp - previous).count());
+		const auto totalUs = static_cast<std::uint32_t>(
+			duration_cast<microseconds>(timestamp - start).count());
+
+		UARTprintf("[EtherCAT]   %s: +%u (%u)\n",
+			phaseStrings[i], phaseUs, totalUs);
+		previous = timestamp;
+	}
+}
+
+} // namespace ethercat
+} // namespace app
+
+void
+ABCC_CbfSyncIsr(void)
+{
+	const auto instance = app::ethercat::EtherCAT::_instance;
+	assert(instance != nullptr);
+	instance->handleSyncISR();
+}
+
+void
+ABCC_CbfEvent(UINT16)
+{
+	const auto instance = app::ethercat::EtherCAT::_instance;
+	assert(instance != nullptr);
+	instance->scheduleDriverRunInterruptCtx();
+}
+
+void
+ABCC_CbfSpiTransferDone()
+{
+	const auto instance = app::ethercat::EtherCAT::_instance;
+	assert(instance != nullptr);
+	instance->markCyclePhase(app::ethercat::EtherCAT::CyclePhase::SpiEnd,
+		instance->_clock.now());
+	instance->scheduleDriverRunInterruptCtx();
+}
+
+void
+ABCC_CbfUserInitReq()
+{
+	const auto instance = app::ethercat::EtherCAT::_instance;
+	assert(instance != nullptr);
+	instance->markBootPhase(app::ethercat::EtherCAT::BootPhase::UserInit);
+
+	const auto moduleType = ABCC_ModuleType();
+	const auto networkType = ABCC_NetworkType();
+
+	// Only ABCC B40 EtherCAT chip supported
+	assert(moduleType == ABP_MODULE_TYPE_ABCC_40);
+	assert(networkType == ABP_NW_TYPE_ECT);
 	static_cast<void>(moduleType);
 	static_cast<void>(networkType);
 
-	// No user init needed, so directly end this phase
-	ABCC_UserInitComplete();
+	// Sync object timing is measured, before the master may read it. User
+	//  init is completed, once it is published
+	instance->startTimingCalibration();
 }
 
 void
@@ -415,13 +1850,31 @@ ABCC_CbfAnbStateChanged(ABP_AnbStateType newAnbState)
 	UARTprintf("[EtherCAT] ABCC state changed: %s\n",
 		stateStrings[newAnbState]);
 
+	const auto instance = app::ethercat::EtherCAT::_instance;
+	assert(instance != nullptr);
+	instance->_anbState = newAnbState;
+
+	using BootPhase = app::ethercat::EtherCAT::BootPhase;
 	switch(newAnbState)
 	{
 	case ABP_ANB_STATE_SETUP:
 		break;
 
+	case ABP_ANB_STATE_NW_INIT:
+		instance->markBootPhase(BootPhase::NetworkInit);
+		break;
+
+	case ABP_ANB_STATE_WAIT_PROCESS:
+		instance->markBootPhase(BootPhase::WaitProcess);
+		break;
+
 	case ABP_ANB_STATE_PROCESS_ACTIVE:
+		instance->configureSyncMode();
 		ABCC_TriggerWrPdUpdate();
+		if(instance->markBootPhase(BootPhase::ProcessActive))
+		{
+			instance->printBootReport();
+		}
 		break;
 
 	default:
@@ -429,26 +1882,75 @@ ABCC_CbfAnbStateChanged(ABP_AnbStateType newAnbState)
 	}
 }
 
-UINT16
-APPL_GetNumAdi(void)
+void
+ABCC_CbfWdTimeout()
 {
-	return(sizeof(APPL_asAdiEntryList) / sizeof(AD_AdiEntryType));
+	const auto instance = app::ethercat::EtherCAT::_instance;
+	assert(instance != nullptr);
+
+	UARTprintf("[EtherCAT] ABCC watchdog timeout\n");
+
+	// Called by the driver timer, so reset the module only after the
+	//  driver is left
+	const auto postSuccess = instance->_eventLoop.post(
+		[instance]()
+		{
+			using State = app::ethercat::EtherCAT::State;
+			if(instance->_state == State::Run)
+			{
+				instance->startRecovery();
+			}
+		});
+	assert(postSuccess);
+	static_cast<void>(postSuccess);
 }
 
 void
-getEncoder0Inputs(const struct AD_AdiEntry* /*adiEntry*/,
-	UINT8 /*numElements*/, UINT8 /*startIndex*/)
+ABCC_CbfSpiSchedEvent(ABCC_SpiSchedEventType event)
 {
 	const auto instance = app::ethercat::EtherCAT::_instance;
 	assert(instance != nullptr);
-	instance->captureEncoder0Inputs();
+	instance->handleSpiSchedEvent(event);
+}
+
+BOOL
+ABCC_CbfUpdateWriteProcessData(void* pxWritePd)
+{
+	/*
+	** AD_UpdatePdWriteData updates all ADI:s according to the copy plan
+	** precomputed from the current map. The buffer is the process data area of
+	** the SPI frame, so no other copy of the process data is made.
+	*/
+	const auto instance = app::ethercat::EtherCAT::_instance;
+	assert(instance != nullptr);
+	instance->updateProbeResponse(instance->_clock.now());
+
+	const auto updated = AD_UpdatePdWriteData(pxWritePd);
+
+	instance->markCyclePhase(app::ethercat::EtherCAT::CyclePhase::PdCopy,
+		instance->_clock.now());
+
+	return updated;
 }
 
 void
-getEncoder1Inputs(const struct AD_AdiEntry* /*adiEntry*/,
-	UINT8 /*numElements*/, UINT8 /*startIndex*/)
+ABCC_CbfNewReadPd(void* pxReadPd)
 {
+	/*
+	** AD_UpdatePdReadData updates all ADI:s according to the copy plan
+	** precomputed from the current map. The buffer is the process data area of
+	** the SPI frame, so no other copy of the process data is made.
+	*/
+	AD_UpdatePdReadData(pxReadPd);
+
 	const auto instance = app::ethercat::EtherCAT::_instance;
 	assert(instance != nullptr);
-	instance->captureEncoder1Inputs();
+	instance->handleProbeRequest(instance->_clock.now());
+	instance->handleNewReadPd();
+}
+
+UINT16
+APPL_GetNumAdi(void)
+{
+	return(sizeof(APPL_asAdiEntryList) / sizeof(AD_AdiEntryType));
 }
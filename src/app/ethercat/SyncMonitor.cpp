@@ -0,0 +1,142 @@
+#include "app/ethercat/SyncMonitor.hpp"
+
+#include "tivaware/utils/uartstdio.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace app {
+namespace ethercat {
+
+void
+SyncMonitor::restart()
+{
+	_hasLastEdge = false;
+}
+
+void
+SyncMonitor::update()
+{
+	const auto head = _head.load(std::memory_order_acquire);
+	auto tail = _tail.load(std::memory_order_relaxed);
+
+	for(; tail != head; ++tail)
+	{
+		const auto period = _periods[tail % QueueSize];
+
+		if(_referenceCycles == 0)
+		{
+			_referenceCycles = period; // The very first period
+		}
+
+		_minCycles = (_count == 0) ? period : std::min(_minCycles, period);
+		_maxCycles = std::max(_maxCycles, period);
+		++_count;
+
+		const auto deviation = static_cast<std::int32_t>(period - _referenceCycles);
+		_sumDeviation += deviation;
+		_sumSquaredDeviation += static_cast<std::uint64_t>(
+			static_cast<std::int64_t>(deviation) * deviation);
+
+		// Bins are counted from the middle, so both directions are symmetric
+		constexpr auto binCycles = static_cast<std::int32_t>(HistogramBinCycles);
+		const auto offset = (deviation >= 0)
+			? deviation / binCycles
+			: (deviation + 1) / binCycles - 1;
+		const auto bin = std::clamp<std::int32_t>(
+			offset + static_cast<std::int32_t>(HistogramBins / 2),
+			0, static_cast<std::int32_t>(HistogramBins - 1));
+		++_histogram[bin];
+	}
+
+	_tail.store(tail, std::memory_order_release);
+}
+
+const SyncMonitor::Stats&
+SyncMonitor::finishWindow(std::uint32_t nominalPeriodNs)
+{
+	update();
+
+	_stats = Stats();
+	_stats.count = _count;
+	_stats.lost = _lost.exchange(0);
+	_stats.referenceNs = toNs(_referenceCycles);
+	_stats.histogram = _histogram;
+
+	auto nextReferenceCycles = toCycles(nominalPeriodNs);
+	if(_count > 0)
+	{
+		// Variance is computed in floating point, single precision is
+		//  enough for nanoseconds and the FPU handles it in hardware
+		const auto mean = static_cast<float>(_sumDeviation) / _count;
+		const auto meanSquare =
+			static_cast<float>(_sumSquaredDeviation) / _count;
+		const auto variance = std::max(meanSquare - mean * mean, 0.0f);
+
+		const auto meanCycles = static_cast<Clock::rep>(
+			static_cast<std::int64_t>(_referenceCycles) + std::lround(mean));
+		_stats.meanNs = toNs(meanCycles);
+		_stats.minNs = toNs(_minCycles);
+		_stats.maxNs = toNs(_maxCycles);
+		_stats.stdDevNs = toNs(static_cast<std::uint64_t>(
+			std::lround(std::sqrt(variance))));
+
+		if(nextReferenceCycles == 0)
+		{
+			nextReferenceCycles = meanCycles;
+		}
+	}
+	else if(nextReferenceCycles == 0)
+	{
+		nextReferenceCycles = _referenceCycles;
+	}
+
+	_referenceCycles = nextReferenceCycles;
+	_count = 0;
+	_minCycles = 0;
+	_maxCycles = 0;
+	_sumDeviation = 0;
+	_sumSquaredDeviation = 0;
+	_histogram.fill(0);
+
+	return _stats;
+}
+
+void
+SyncMonitor::print() const
+{
+	if(_stats.count == 0)
+	{
+		return; // No SYNC
+	}
+
+	UARTprintf("[SyncMonitor] period [ns]: mean %u, min %u, max %u,"
+		" jitter %u, stddev %u (%u, lost %u)\n",
+		_stats.meanNs, _stats.minNs, _stats.maxNs,
+		_stats.maxNs - _stats.minNs, _stats.stdDevNs,
+		_stats.count, _stats.lost);
+
+	UARTprintf("[SyncMonitor] histogram around %u ns, %u ns bins:",
+		_stats.referenceNs, HistogramBinNs);
+	for(const auto binCount : _stats.histogram)
+	{
+		UARTprintf(" %u", binCount);
+	}
+	UARTprintf("\n");
+}
+
+std::uint32_t
+SyncMonitor::toNs(std::uint64_t cycles)
+{
+	return static_cast<std::uint32_t>(cycles * 1000000000ULL / Clock::Frequency);
+}
+
+SyncMonitor::Clock::rep
+SyncMonitor::toCycles(std::uint32_t ns)
+{
+	return static_cast<Clock::rep>(
+		static_cast<std::uint64_t>(ns) * Clock::Frequency / 1000000000ULL);
+}
+
+} // namespace ethercat
+} // namespace app
@@ -0,0 +1,121 @@
+#include "app/ethercat/SyncPll.hpp"
+
+#include "tivaware/utils/uartstdio.h"
+
+#include <utility>
+
+namespace app {
+namespace ethercat {
+
+void
+SyncPll::trackEdge(Clock::time_point edgeTime)
+{
+	const auto hadLastEdge = std::exchange(_hasLastEdge, true);
+	const auto measuredPeriod = (edgeTime - _lastEdge).count();
+	_lastEdge = edgeTime;
+
+	if(!hadLastEdge || measuredPeriod > MaxPeriodCycles)
+	{
+		reset();
+		_hasLastEdge = true;
+		return; // Nothing to pair with
+	}
+
+	const auto edge = edgeTime.time_since_epoch().count();
+	if(_periodQ == 0)
+	{
+		// Acquisition, measured period is the first estimate
+		_periodQ = static_cast<std::uint64_t>(measuredPeriod) << FracBits;
+		_nextEdge = edge + measuredPeriod;
+		_nextEdgeFrac = 0;
+		return;
+	}
+
+	// Clock wraps around, but the difference of close points does not
+	const auto error = static_cast<std::int32_t>(edge - _nextEdge);
+	_phaseError = error;
+
+	const auto period = static_cast<std::int32_t>(_periodQ >> FracBits);
+	if(error > period / 4 || error < -period / 4)
+	{
+		// Missed or extra edge, or the master changed the cycle. The period
+		//  is acquired again from the next edge
+		unlock();
+		_periodQ = 0;
+		return;
+	}
+
+	_periodQ = static_cast<std::uint64_t>(static_cast<std::int64_t>(_periodQ)
+		+ (static_cast<std::int64_t>(error) << (FracBits - IntegralShift)));
+
+	const auto step = static_cast<std::int64_t>(_periodQ)
+		+ (static_cast<std::int64_t>(error) << (FracBits - ProportionalShift))
+		+ _nextEdgeFrac;
+	_nextEdge += static_cast<Clock::rep>(step >> FracBits);
+	_nextEdgeFrac = static_cast<std::uint32_t>(step) & FracMask;
+
+	const auto absError = (error < 0) ? -error : error;
+	if(_locked)
+	{
+		if(absError > UnlockThresholdCycles)
+		{
+			unlock();
+		}
+	}
+	else if(absError > LockThresholdCycles)
+	{
+		_edgesInLock = 0;
+	}
+	else if(++_edgesInLock >= LockEdges)
+	{
+		_locked = true;
+		++_lockCount;
+	}
+}
+
+void
+SyncPll::reset()
+{
+	unlock();
+	_hasLastEdge = false;
+	_periodQ = 0;
+	_phaseError = 0;
+}
+
+void
+SyncPll::print() const
+{
+	const auto period = getPeriod();
+	if(period.count() == 0)
+	{
+		return; // Not acquired
+	}
+
+	UARTprintf("[SyncPll] %s, period %u ns, phase error %d ns"
+		" (locks %u, unlocks %u)\n",
+		_locked ? "locked" : "unlocked",
+		static_cast<std::uint32_t>(toNs(static_cast<std::int32_t>(period.count()))),
+		toNs(_phaseError), _lockCount, _unlockCount);
+}
+
+std::int32_t
+SyncPll::toNs(std::int32_t cycles)
+{
+	return static_cast<std::int32_t>(
+		static_cast<std::int64_t>(cycles) * 1000000000LL / Clock::Frequency);
+}
+
+void
+SyncPll::unlock()
+{
+	if(_locked)
+	{
+		++_unlockCount;
+	}
+
+	_locked = false;
+	_edgesInLock = 0;
+}
+
+} // namespace ethercat
+} // namespace app
@@ -52,6 +52,111 @@ static uint8_t dmaControlTable[1024];
 //! uDMA SSI1TX channel asignment
 #define SSI1TX_ASGN UDMA_CH25_SSI1TX
 
+#if( ABCC_CFG_SPI_16_BIT_FRAMES )
+//! SSI1 frame width, with matching uDMA item size and address increments
+#define SPI_FRAME_WIDTH 16
+#define SPI_DMA_SIZE    UDMA_SIZE_16
+#define SPI_DMA_SRC_INC UDMA_SRC_INC_16
+#define SPI_DMA_DST_INC UDMA_DST_INC_16
+#else
+//! SSI1 frame width, with matching uDMA item size and address increments
+#define SPI_FRAME_WIDTH 8
+#define SPI_DMA_SIZE    UDMA_SIZE_8
+#define SPI_DMA_SRC_INC UDMA_SRC_INC_8
+#define SPI_DMA_DST_INC UDMA_DST_INC_8
+#endif
+
+//! Number of octets moved by a single SSI frame and uDMA item
+#define SPI_FRAME_OCTETS (SPI_FRAME_WIDTH / 8)
+
+//! Maximum number of items in a single uDMA transfer
+#define DMA_MAX_ITEMS 1024
+
+//! The SPI clock steps down after SPI_CRC_ERROR_LIMIT CRC errors within
+//! SPI_CRC_ERROR_WINDOW frames. Sporadic errors are left to retransmission
+#define SPI_CRC_ERROR_LIMIT 3
+#define SPI_CRC_ERROR_WINDOW 1000
+
+//! Current SPI clock
+static uint32_t spiClockHz = ABCC_CFG_SPI_CLOCK_HZ;
+
+#if( ABCC_CFG_SPI_CLOCK_FALLBACK )
+//! Frames checked and CRC errors found in the current window
+static uint32_t spiCheckedFrames = 0;
+static uint32_t spiCrcErrors = 0;
+#endif
+
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+//! uDMA scatter-gather task lists, one task per MISO and MOSI frame segment
+static tDMAControlTable spiRxTasks[ABCC_SYS_SPI_MAX_NUM_SEGMENTS];
+static tDMAControlTable spiTxTasks[ABCC_SYS_SPI_MAX_NUM_SEGMENTS];
+#endif
+
+#if( ABCC_CFG_SPI_16_BIT_FRAMES )
+//! Segments of the ongoing transfer. Their octets are swapped for the
+//! transfer, and swapped back by ABCC_SYS_SpiFinishTransfer(), outside of the
+//! SSI1 interrupt
+static ABCC_SYS_SpiSegmentType spiTxSegments[ABCC_SYS_SPI_MAX_NUM_SEGMENTS];
+static UINT8 spiNumTxSegments = 0;
+static ABCC_SYS_SpiSegmentType spiRxSegments[ABCC_SYS_SPI_MAX_NUM_SEGMENTS];
+static UINT8 spiNumRxSegments = 0;
+
+//! SSI shifts a frame starting from its most significant bit, so a 16-bit
+//! frame carries the high octet of a word first. ABCC expects the octets in
+//! memory order, so they are swapped in every word of the segments
+static void swapSpiOctets(const ABCC_SYS_SpiSegmentType* segments,
+   UINT8 numSegments)
+{
+   for(UINT8 i = 0; i < numSegments; ++i)
+   {
+      UINT16* word = (UINT16*)segments[i].pxData;
+
+      for(UINT16 j = 0; j < segments[i].iLength / 2; ++j)
+      {
+         word[j] = ABCC_iEndianSwap(word[j]);
+      }
+   }
+}
+
+//! Remembers the segments of the transfer being started and swaps octets of
+//! the MOSI frame segments for it
+static void prepareSpiSegments(const ABCC_SYS_SpiSegmentType* sendSegments,
+   UINT8 numSendSegments,
+   const ABCC_SYS_SpiSegmentType* receiveSegments,
+   UINT8 numReceiveSegments)
+{
+   for(UINT8 i = 0; i < numSendSegments; ++i)
+   {
+      assert(sendSegments[i].iLength % SPI_FRAME_OCTETS == 0);
+      spiTxSegments[i] = sendSegments[i];
+   }
+   spiNumTxSegments = numSendSegments;
+
+   for(UINT8 i = 0; i < numReceiveSegments; ++i)
+   {
+      assert(receiveSegments[i].iLength % SPI_FRAME_OCTETS == 0);
+      spiRxSegments[i] = receiveSegments[i];
+   }
+   spiNumRxSegments = numReceiveSegments;
+
+   swapSpiOctets(spiTxSegments, spiNumTxSegments);
+}
+#endif
+
+//! Configures SSI1: SPI3 mode, master, given clock and frame width.
+//! SSI1 is disabled for the reconfiguration, so it must not be busy
+static void setSpiClock(uint32_t clockHz)
+{
+   assert(!SSIBusy(SSI1_BASE));
+
+   SSIDisable(SSI1_BASE);
+   MAP_SSIConfigSetExpClk(SSI1_BASE, MAP_SysCtlClockGet(),
+      SSI_FRF_MOTO_MODE_3, SSI_MODE_MASTER, clockHz, SPI_FRAME_WIDTH);
+   SSIEnable(SSI1_BASE);
+
+   spiClockHz = clockHz;
+}
+
 //! Interrupt Service Routine for Port E.
 //! Handles interrupts from IRQ and MI0/SYNC pins
 void portE_ISR()
@@ -70,16 +175,14 @@ void portE_ISR()
    else
    {
       assert(maskedStatus & IRQ_PIN);
-      UARTprintf("IRQ interrupt\n");
       ABCC_ISR();
    }
 }
 
-volatile bool sent = false;
-
 //! Interrupt Service Routine for SSI1
 //! It will be invoked, when DMA has finished either TX or RX.
-//! When RX has been finished, `spiDataReceivedCb` will be called.
+//! When RX has been finished, `spiDataReceivedCb` will be called and
+//! the application will be notified, so it can schedule ABCC_RunDriver()
 void ssi1_ISR()
 {
    assert(SSIIntStatus(SSI1_BASE, true) == 0); // only DMA interrupts allowed
@@ -92,8 +195,8 @@ void ssi1_ISR()
    {
       // DMA SSIRX transfer completed. Invoke the callback to the ABCC
       assert(spiDataReceivedCb);
-      sent = true;
       spiDataReceivedCb();
+      ABCC_CbfSpiTransferDone();
       dmaIntClearMask |= SSI1RX_CH_M;
    }
 
@@ -144,17 +247,17 @@ BOOL ABCC_SYS_HwInit()
 
    // Configure SSI1RX uDMA channel:
    // - Source address fixed (SSI1RX FIFO)
-   // - Destination address increments by byte (MISO frame)
+   // - Destination address increments by SSI frame (MISO frame)
    MAP_uDMAChannelControlSet(SSI1RX_CH | UDMA_PRI_SELECT,
-      UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_8);
+      SPI_DMA_SIZE | UDMA_SRC_INC_NONE | SPI_DMA_DST_INC | UDMA_ARB_8);
    MAP_uDMAChannelAssign(SSI1RX_ASGN);
    MAP_uDMAChannelAttributeDisable(SSI1RX_CH, UDMA_ATTR_REQMASK);
 
    // Configure SSI1TX uDMA channel:
-   // - Source address increments by byte (MOSI frame)
+   // - Source address increments by SSI frame (MOSI frame)
    // - Destination address fixed (SSI1TX FIFO)
    MAP_uDMAChannelControlSet(SSI1TX_CH | UDMA_PRI_SELECT,
-      UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_8);
+      SPI_DMA_SIZE | SPI_DMA_SRC_INC | UDMA_DST_INC_NONE | UDMA_ARB_8);
    MAP_uDMAChannelAssign(SSI1TX_ASGN);
    MAP_uDMAChannelAttributeDisable(SSI1TX_CH, UDMA_ATTR_REQMASK);
 
@@ -169,13 +272,11 @@ BOOL ABCC_SYS_HwInit()
    MAP_GPIOPinConfigure(GPIO_PD2_SSI1RX);
    MAP_GPIOPinConfigure(GPIO_PD3_SSI1TX);
 
-   // configure SSI1: SPI3 mode, master, 5MHz and 8bits frame width, DMA RX+TX
+   // Configure SSI1: DMA RX+TX, SPI3 mode, master, initial clock
    MAP_SysCtlPeripheralEnable(SYSCTL_PERIPH_SSI1);
-   MAP_SSIConfigSetExpClk(SSI1_BASE, MAP_SysCtlClockGet(),
-      SSI_FRF_MOTO_MODE_3, SSI_MODE_MASTER, 13000000, 8);
    MAP_SSIDMAEnable(SSI1_BASE, SSI_DMA_TX | SSI_DMA_RX);
    SSIIntRegister(SSI1_BASE, ssi1_ISR);
-   SSIEnable(SSI1_BASE);
+   setSpiClock(ABCC_CFG_SPI_CLOCK_HZ);
 
    return true;
 }
@@ -187,10 +288,25 @@ BOOL ABCC_SYS_Init()
    return true;
 }
 
-//! Should release all alocated resources. In this case, does nothing.
+//! Should release all alocated resources. Aborts SPI transfer, which may be
+//! in progress when the driver is shut down for the module reset, so the
+//! restarted driver is not notified about it
 void ABCC_SYS_Close()
 {
-   /* do nothing */
+   uDMAChannelDisable(SSI1TX_CH);
+   uDMAChannelDisable(SSI1RX_CH);
+   uDMAIntClear(SSI1TX_CH_M | SSI1RX_CH_M);
+   IntPendClear(INT_SSI1);
+
+   // Let SSI shift out the frames already in TX FIFO and drop what it got
+   while(SSIBusy(SSI1_BASE))
+   {
+   }
+
+   uint32_t data;
+   while(SSIDataGetNonBlocking(SSI1_BASE, &data))
+   {
+   }
 }
 
 //! Sets Reset pin to LOW
@@ -205,6 +321,12 @@ void ABCC_SYS_HWReleaseReset()
    GPIOPinWrite(GPIO_PORTE_BASE, RESET_PIN, RESET_PIN);
 }
 
+//! IRQ pin is active LOW
+BOOL ABCC_SYS_IsAbccInterruptActive()
+{
+   return (GPIOPinRead(GPIO_PORTE_BASE, IRQ_PIN) & IRQ_PIN) ? false : true;
+}
+
 //! Module type is fixed: CC40
 UINT8 ABCC_SYS_ReadModuleId()
 {
@@ -223,27 +345,23 @@ BOOL ABCC_SYS_ModuleDetect()
 
 void ABCC_SYS_SyncInterruptEnable()
 {
-   UARTprintf("Enabling SYNC interrupt\n");
    GPIOIntEnable(GPIO_PORTE_BASE, MI0_SYNC_PIN);
 }
 
 void ABCC_SYS_SyncInterruptDisable()
 {
-   UARTprintf("Disabling SYNC interrupt\n");
    GPIOIntDisable(GPIO_PORTE_BASE, MI0_SYNC_PIN);
 }
 
 //! Enables interrupt from IRQ pin
 void ABCC_SYS_AbccInterruptEnable()
 {
-   UARTprintf("Enabling IRQ pin\n");
    GPIOIntEnable(GPIO_PORTE_BASE, IRQ_PIN);
 }
 
 //! Disables interrupt from IRQ pin
 void ABCC_SYS_AbccInterruptDisable()
 {
-   UARTprintf("Disabling IRQ pin\n");
    GPIOIntDisable(GPIO_PORTE_BASE, IRQ_PIN);
 }
 
@@ -254,19 +372,35 @@ void ABCC_SYS_SpiRegDataReceived(ABCC_SYS_SpiDataReceivedCbfType pnDataReceived
 }
 
 //! Sends MOSI frame and simultaneously receives MISO frame using DMA.
-//! At the end, SSI1/DMA ISR will invoke `spiDataReceivedCb` callback
+//! Returns right after the transfer is started. At the end, SSI1/DMA ISR
+//! will invoke `spiDataReceivedCb` callback
 void ABCC_SYS_SpiSendReceive(void* pxSendDataBuffer, void* pxReceiveDataBuffer, UINT16 iLength)
 {
-   assert(iLength < 1024); // valid length to use DMA
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+   // Scatter-gather transfers overwrite the channel control set up in
+   // ABCC_SYS_HwInit(), so send the frames as single segments instead
+   const ABCC_SYS_SpiSegmentType sendSegment = {pxSendDataBuffer, iLength};
+   const ABCC_SYS_SpiSegmentType receiveSegment = {pxReceiveDataBuffer, iLength};
+
+   ABCC_SYS_SpiSendReceiveSegments(&sendSegment, 1, &receiveSegment, 1);
+#else
+   assert(iLength / SPI_FRAME_OCTETS <= DMA_MAX_ITEMS); // valid length to use DMA
    assert(!SSIBusy(SSI1_BASE));
 
+#if( ABCC_CFG_SPI_16_BIT_FRAMES )
+   const ABCC_SYS_SpiSegmentType sendSegment = {pxSendDataBuffer, iLength};
+   const ABCC_SYS_SpiSegmentType receiveSegment = {pxReceiveDataBuffer, iLength};
+
+   prepareSpiSegments(&sendSegment, 1, &receiveSegment, 1);
+#endif
+
    // Prepare SSIRX DMA channel buffers. Source=SSIRX, Destination=MISO frame
    void* rxSrcBuffer = (void*)(SSI_O_DR + SSI1_BASE);
    void* rxDstBuffer = ((uint8_t*)(pxReceiveDataBuffer));
 
    // Configure SSIRX DMA channel to receive MISO frame
    uDMAChannelTransferSet(SSI1RX_CH | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
-      rxSrcBuffer, rxDstBuffer, iLength);
+      rxSrcBuffer, rxDstBuffer, iLength / SPI_FRAME_OCTETS);
 
    // Prepare SSITX DMA channel buffer. Source=MOSI frame, Destination=SSITX
    void* txSrcBuffer = ((uint8_t*)(pxSendDataBuffer));
@@ -274,16 +408,115 @@ void ABCC_SYS_SpiSendReceive(void* pxSendDataBuffer, void* pxReceiveDataBuffer,
 
    // Configure SSITX DMA channel to transmit MOSI frame
    uDMAChannelTransferSet(SSI1TX_CH | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
-      txSrcBuffer, txDstBuffer, iLength);
+      txSrcBuffer, txDstBuffer, iLength / SPI_FRAME_OCTETS);
 
-   sent = false;
+   // Enable SSIRX and then SSITX DMA channels
+   uDMAChannelEnable(SSI1RX_CH);
+   uDMAChannelEnable(SSI1TX_CH);
+#endif
+}
+
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+//! Sends MOSI frame and simultaneously receives MISO frame, both given as
+//! lists of segments, using DMA in peripheral scatter-gather mode.
+//! Each segment is one task. All tasks but the last one continue with the
+//! next task, the last one completes the transfer like in the basic mode.
+//! Returns right after the transfer is started.
+void ABCC_SYS_SpiSendReceiveSegments(const ABCC_SYS_SpiSegmentType* psSendSegments,
+   UINT8 bNumSendSegments,
+   const ABCC_SYS_SpiSegmentType* psReceiveSegments,
+   UINT8 bNumReceiveSegments)
+{
+   assert(bNumSendSegments > 0 && bNumSendSegments <= ABCC_SYS_SPI_MAX_NUM_SEGMENTS);
+   assert(bNumReceiveSegments > 0 && bNumReceiveSegments <= ABCC_SYS_SPI_MAX_NUM_SEGMENTS);
+   assert(!SSIBusy(SSI1_BASE));
+
+#if( ABCC_CFG_SPI_16_BIT_FRAMES )
+   prepareSpiSegments(psSendSegments, bNumSendSegments,
+      psReceiveSegments, bNumReceiveSegments);
+#endif
+
+   void* ssiDataRegister = (void*)(SSI_O_DR + SSI1_BASE);
+
+   // Prepare SSIRX DMA tasks. Source=SSIRX, Destination=MISO frame segment
+   for(UINT8 i = 0; i < bNumReceiveSegments; ++i)
+   {
+      const ABCC_SYS_SpiSegmentType* segment = &psReceiveSegments[i];
+      const UINT16 numItems = segment->iLength / SPI_FRAME_OCTETS;
+      assert(numItems > 0 && numItems <= DMA_MAX_ITEMS); // valid length to use DMA
+
+      spiRxTasks[i] = (tDMAControlTable)uDMATaskStructEntry(numItems,
+         SPI_DMA_SIZE, ssiDataRegister, UDMA_SRC_INC_NONE,
+         segment->pxData, SPI_DMA_DST_INC, UDMA_ARB_8,
+         (i + 1 < bNumReceiveSegments) ? UDMA_MODE_PER_SCATTER_GATHER : UDMA_MODE_BASIC);
+   }
+
+   // Prepare SSITX DMA tasks. Source=MOSI frame segment, Destination=SSITX
+   for(UINT8 i = 0; i < bNumSendSegments; ++i)
+   {
+      const ABCC_SYS_SpiSegmentType* segment = &psSendSegments[i];
+      const UINT16 numItems = segment->iLength / SPI_FRAME_OCTETS;
+      assert(numItems > 0 && numItems <= DMA_MAX_ITEMS); // valid length to use DMA
+
+      spiTxTasks[i] = (tDMAControlTable)uDMATaskStructEntry(numItems,
+         SPI_DMA_SIZE, segment->pxData, SPI_DMA_SRC_INC,
+         ssiDataRegister, UDMA_DST_INC_NONE, UDMA_ARB_8,
+         (i + 1 < bNumSendSegments) ? UDMA_MODE_PER_SCATTER_GATHER : UDMA_MODE_BASIC);
+   }
+
+   // Point the channels to their task lists
+   uDMAChannelScatterGatherSet(SSI1RX_CH, bNumReceiveSegments, spiRxTasks, true);
+   uDMAChannelScatterGatherSet(SSI1TX_CH, bNumSendSegments, spiTxTasks, true);
 
    // Enable SSIRX and then SSITX DMA channels
    uDMAChannelEnable(SSI1RX_CH);
    uDMAChannelEnable(SSI1TX_CH);
+}
+#endif
+
+#if( ABCC_CFG_SPI_16_BIT_FRAMES )
+//! Restores octets of the MOSI frame segments, it may be retransmitted, and
+//! brings the MISO frame segments to memory order. Called by the driver from
+//! its run context, before it checks the MISO frame
+void ABCC_SYS_SpiFinishTransfer()
+{
+   swapSpiOctets(spiTxSegments, spiNumTxSegments);
+   spiNumTxSegments = 0;
+
+   swapSpiOctets(spiRxSegments, spiNumRxSegments);
+   spiNumRxSegments = 0;
+}
+#endif
+
+#if( ABCC_CFG_SPI_CLOCK_FALLBACK )
+//! Counts CRC errors of the received MISO frames. Once too many of them occur
+//! within a window, halves the SPI clock, but not below the minimum one.
+//! Called by the driver between the transfers, so SSI1 is idle
+void ABCC_SYS_SpiFrameCrcChecked(BOOL fCrcValid)
+{
+   ++spiCheckedFrames;
+   if(!fCrcValid)
+   {
+      ++spiCrcErrors;
+   }
+
+   if(spiCrcErrors >= SPI_CRC_ERROR_LIMIT)
+   {
+      if(spiClockHz / 2 >= ABCC_CFG_SPI_MIN_CLOCK_HZ)
+      {
+         setSpiClock(spiClockHz / 2);
+      }
 
-   while(!sent);
+      spiCheckedFrames = 0;
+      spiCrcErrors = 0;
+   }
+   else if(spiCheckedFrames >= SPI_CRC_ERROR_WINDOW)
+   {
+      spiCheckedFrames = 0;
+      spiCrcErrors = 0;
+   }
 }
+#endif
 
 void ABCC_SYS_GpioSet()
 {
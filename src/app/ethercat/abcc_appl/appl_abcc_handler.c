@@ -95,27 +95,16 @@ UINT16  ABCC_CbfAdiMappingReq(const AD_AdiEntryType**  const ppsAdiEntry,
    return AD_AdiMappingReq(ppsAdiEntry, ppsDefaultMap);
 }
 
-BOOL ABCC_CbfUpdateWriteProcessData(void* pxWritePd)
+#if( ABCC_CFG_REMAP_SUPPORT_ENABLED )
+void ABCC_CbfRemapDone(void)
 {
    /*
-   ** AD_UpdatePdWriteData is a general function that updates all ADI:s according
-   ** to current map.
-   ** If the ADI mapping is fixed there is potential for doing that in a more
-   ** optimized way, for example by using memcpy.
+   ** New process data sizes are already set by the driver, so the SPI frames
+   ** have been resized. Let the AD object take the new map into use.
    */
-   return(AD_UpdatePdWriteData(pxWritePd));
-}
-
-void ABCC_CbfNewReadPd(void* pxReadPd)
-{
-   /*
-   ** AD_UpdatePdReadData is a general function that updates all ADI:s according
-   ** to current map.
-   ** If the ADI mapping is fixed there is potential for doing that in a more
-   ** optimized way, for example by using memcpy.
-   */
-   AD_UpdatePdReadData(pxReadPd);
+   AD_RemapDone();
 }
+#endif
 
 void ABCC_CbfDriverError(ABCC_SeverityType eSeverity, ABCC_ErrorCodeType iErrorCode, UINT32 lAddInfo)
 {
@@ -165,11 +154,6 @@ void ABCC_CbfReceiveMsg(ABP_MsgType* psReceivedMsg)
    }
 }
 
-void ABCC_CbfWdTimeout(void)
-{
-   ABCC_PORT_DebugPrint(("ABCC watchdog timeout"));
-}
-
 void ABCC_CbfWdTimeoutRecovered(void)
 {
    ABCC_PORT_DebugPrint(("ABCC watchdog recovered"));
@@ -114,9 +114,11 @@ EXTFUNC void ABCC_SerISR( void );
 ** Registered handler functions
 */
 
+#if( !ABCC_CFG_DRV_SPI_STATIC_BINDING )
 ABCC_ErrorCodeType ( *ABCC_RunDriver )( void );
 void ( *ABCC_ISR )( void );
 void ( *ABCC_TriggerWrPdUpdate )( void );
+#endif
 
 /*
 ** The interrupt mask that has been set to the ABCC at start up.
@@ -127,6 +129,7 @@ UINT16 ABCC_iInterruptEnableMask;
 ** Registerd driver functions
 */
 
+#if( !ABCC_CFG_DRV_SPI_STATIC_BINDING )
 void  ( *pnABCC_DrvInit )( UINT8 bOpmode );
 UINT16 ( *pnABCC_DrvISR )( void );
 void ( *pnABCC_DrvRunDriverTx )( void );
@@ -150,6 +153,7 @@ void* ( *pnABCC_DrvReadProcessData )( void );
 ABP_MsgType* ( *pnABCC_DrvReadMessage )( void );
 BOOL ( *pnABCC_DrvIsSupervised )( void );
 UINT8 ( *pnABCC_DrvGetAnbStatus )( void );
+#endif
 
 #if( ABCC_CFG_SYNC_MEASUREMENT_IP )
 BOOL fAbccUserSyncMeasurementIp;
@@ -166,6 +170,8 @@ static ABCC_MainStateType abcc_eMainState = ABCC_DRV_INIT;
 
 /*
 ** Pointer to WRPD buffer.
+** Fetched again before each update, since the SPI driver moves the process
+** data within the frame when the message fragment length is changed.
 */
 static void* abcc_pbWrPdBuffer;
 
@@ -213,6 +219,7 @@ static void TriggerWrPdUpdateNow( void )
       */
       if( pnABCC_DrvISReadyForWrPd() )
       {
+         abcc_pbWrPdBuffer = pnABCC_DrvGetWrPdBuffer();
          if( ABCC_CbfUpdateWriteProcessData( abcc_pbWrPdBuffer ) )
          {
             pnABCC_DrvWriteProcessData( abcc_pbWrPdBuffer );
@@ -297,6 +304,13 @@ static void SetReadyForCommunicationTmo( void )
 ********************************************************************************
 */
 
+#if( ABCC_CFG_DRV_SPI_STATIC_BINDING )
+void ABCC_SpiTriggerWrPdUpdate( void )
+{
+   TriggerWrPdUpdateLater();
+}
+#endif
+
 #if( ABCC_CFG_DRV_SPI || ABCC_CFG_DRV_PARALLEL_30 || ABCC_CFG_DRV_SERIAL )
 void ABCC_CheckWrPdUpdate( void )
 {
@@ -308,6 +322,41 @@ void ABCC_CheckWrPdUpdate( void )
 }
 #endif
 
+BOOL ABCC_IsRunDriverPending( void )
+{
+   if( abcc_eMainState < ABCC_DRV_SETUP )
+   {
+      return( FALSE );
+   }
+
+#if( ABCC_CFG_DRV_SPI && ABCC_CFG_INT_ENABLED )
+   if( abcc_bOpmode == ABP_OP_MODE_SPI )
+   {
+      if( ABCC_DrvSpiIsTransferPending() )
+      {
+         return( TRUE );
+      }
+
+      if( ABCC_DrvSpiIsTransferOngoing() )
+      {
+         /*
+         ** Transfer is ongoing. The end of the transfer will trigger the next
+         ** run of the driver, but the write process data can already be
+         ** written to the next MOSI frame.
+         */
+         return( abcc_fDoWrPdUpdate );
+      }
+
+      return( abcc_fDoWrPdUpdate || ABCC_SYS_IsAbccInterruptActive() );
+   }
+#endif
+
+   /*
+   ** Other operating modes, or no interrupt support, have to be polled.
+   */
+   return( TRUE );
+}
+
 void ABCC_SetReadyForCommunication( void )
 {
    abcc_fReadyForCommunication = TRUE;
@@ -433,6 +482,7 @@ ABCC_ErrorCodeType ABCC_StartDriver( UINT32 lMaxStartupTimeMs )
 
       if( bModuleId == ABP_MODULE_ID_ACTIVE_ABCC40 )
       {
+#if( !ABCC_CFG_DRV_SPI_STATIC_BINDING )
          ABCC_ISR                   = &ABCC_SpiISR;
          ABCC_RunDriver             = &ABCC_SpiRunDriver;
          ABCC_TriggerWrPdUpdate     = &TriggerWrPdUpdateLater;
@@ -460,6 +510,7 @@ ABCC_ErrorCodeType ABCC_StartDriver( UINT32 lMaxStartupTimeMs )
          pnABCC_DrvReadMessage        = &ABCC_DrvSpiReadMessage;
          pnABCC_DrvIsSupervised       = &ABCC_DrvSpiIsSupervised;
          pnABCC_DrvGetAnbStatus       = &ABCC_DrvSpiGetAnbStatus;
+#endif /* End of #if !ABCC_CFG_DRV_SPI_STATIC_BINDING */
 
          ABCC_iInterruptEnableMask = ABCC_CFG_INT_ENABLE_MASK_SPI;
       }
@@ -692,6 +743,7 @@ void ABCC_NewWrPdEvent( void )
       */
       if ( pnABCC_DrvISReadyForWrPd() )
       {
+         abcc_pbWrPdBuffer = pnABCC_DrvGetWrPdBuffer();
          if( ABCC_CbfUpdateWriteProcessData( abcc_pbWrPdBuffer ) )
          {
             pnABCC_DrvWriteProcessData( abcc_pbWrPdBuffer );
@@ -102,6 +102,66 @@ static ABCC_CmdSeqRespStatusType SetupCompleteResp( ABP_MsgType* psMsg );
 
 static void SetupDone( void );
 
+#if ABCC_CFG_DRV_CMD_SEQ_ENABLE
+static void SetupSeqBeforeUserInitDone( void );
+static void PdSizeSeqDone( void );
+
+/*
+** The command sequencer runs several sequences at once. Setup commands which
+** do not depend on each other are therefore split into parallel sequences,
+** so their round trips to the ABCC overlap instead of adding up. At most
+** ABCC_CFG_MAX_NUM_APPL_CMDS sequences are run at the same time, any further
+** command would only wait for a free message buffer.
+*/
+#if( ABCC_CFG_MAX_NUM_CMD_SEQ < 2 )
+#error "Setup needs at least 2 command sequences to be run in parallel"
+#endif
+
+/*
+** Command sequences until user setup. Both must be done before user init is
+** triggered.
+** The ADI map resolves its copy plans for the network data format, so the
+** data format is read first in the mapping sequence, not with the module info.
+*/
+static const ABCC_CmdSeqType SetupSeqModuleInfo[] =
+{
+   ABCC_CMD_SEQ( ParamSupportCmd,    ParamSupportResp ),
+   ABCC_CMD_SEQ( ModuleTypeCmd,      ModuleTypeResp ),
+   ABCC_CMD_SEQ( NetworkTypeCmd,     NetworkTypeResp ),
+   ABCC_CMD_SEQ( FirmwareVersionCmd, FirmwareVersionResp ),
+   ABCC_CMD_SEQ_END()
+};
+
+static const ABCC_CmdSeqType SetupSeqPdMapping[] =
+{
+   ABCC_CMD_SEQ( DataFormatCmd,      DataFormatResp ),
+   ABCC_CMD_SEQ( PreparePdMapping,   NULL ),
+   ABCC_CMD_SEQ( ReadWriteMapCmd,    ReadWriteMapResp ),
+   ABCC_CMD_SEQ_END()
+};
+
+/*
+** Command sequences after user setup. Process data sizes are verified in
+** parallel, setup complete is sent when both of them are done.
+*/
+static const ABCC_CmdSeqType SetupSeqRdPdSize[] =
+{
+   ABCC_CMD_SEQ( RdPdSizeCmd,      RdPdSizeResp ),
+   ABCC_CMD_SEQ_END()
+};
+
+static const ABCC_CmdSeqType SetupSeqWrPdSize[] =
+{
+   ABCC_CMD_SEQ( WrPdSizeCmd,      WrPdSizeResp ),
+   ABCC_CMD_SEQ_END()
+};
+
+static const ABCC_CmdSeqType SetupSeqComplete[] =
+{
+   ABCC_CMD_SEQ( SetupCompleteCmd, SetupCompleteResp ),
+   ABCC_CMD_SEQ_END()
+};
+#else
 /*
 ** Command sequence until user setup.
 */
@@ -127,6 +187,7 @@ static const ABCC_CmdSeqType SetupSeqAfterUserInit[] =
    ABCC_CMD_SEQ( SetupCompleteCmd, SetupCompleteResp ),
    ABCC_CMD_SEQ_END()
 };
+#endif
 
 
 /*------------------------------------------------------------------------------
@@ -210,6 +271,12 @@ static UINT8 bSetupSubState = 0;
 ** SETUP_AFTER_USER_INIT:  SetupSeqAfterUserInit[]
 */
 static const ABCC_CmdSeqType* pasSetupSeq;
+#else
+
+/*
+** Number of parallel setup sequences not done yet
+*/
+static UINT8 abcc_bNumPendingSetupSeq = 0;
 #endif
 
 /*******************************************************************************
@@ -824,6 +891,40 @@ static void SetupDone( void )
    DEBUG_EVENT( ( "Mapped PD size, RdPd %d WrPd: %d\n", abcc_iPdReadSize, abcc_iPdWriteSize ) );
 }
 
+#if ABCC_CFG_DRV_CMD_SEQ_ENABLE
+/*------------------------------------------------------------------------------
+** Joins the parallel sequences run before user init. User init is triggered
+** when the last of them is done.
+** Implements function callback ABCC_CmdSeqDoneHandler (abcc.h)
+**------------------------------------------------------------------------------
+*/
+static void SetupSeqBeforeUserInitDone( void )
+{
+   ABCC_ASSERT( abcc_bNumPendingSetupSeq > 0 );
+
+   if( --abcc_bNumPendingSetupSeq == 0 )
+   {
+      TriggerUserInit();
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Joins the parallel process data size sequences. Setup complete is sent when
+** the last of them is done.
+** Implements function callback ABCC_CmdSeqDoneHandler (abcc.h)
+**------------------------------------------------------------------------------
+*/
+static void PdSizeSeqDone( void )
+{
+   ABCC_ASSERT( abcc_bNumPendingSetupSeq > 0 );
+
+   if( --abcc_bNumPendingSetupSeq == 0 )
+   {
+      ABCC_AddCmdSeq( SetupSeqComplete, SetupDone );
+   }
+}
+#endif
+
 #if !ABCC_CFG_DRV_CMD_SEQ_ENABLE
 /*------------------------------------------------------------------------------
 ** Handles responses for setup messages.
@@ -904,12 +1005,20 @@ static void SendSetupCommand( ABP_MsgType* psMsg )
 #if ABCC_CFG_DRV_CMD_SEQ_ENABLE
 void ABCC_StartSetup( void )
 {
-   ABCC_AddCmdSeq( SetupSeqBeforeUserInit, TriggerUserInit );
+   /*
+   ** Counter is set before the sequences are added, as a sequence with
+   ** nothing to send is done right away.
+   */
+   abcc_bNumPendingSetupSeq = 2;
+   ABCC_AddCmdSeq( SetupSeqModuleInfo, SetupSeqBeforeUserInitDone );
+   ABCC_AddCmdSeq( SetupSeqPdMapping, SetupSeqBeforeUserInitDone );
 }
 
 void ABCC_UserInitComplete( void )
 {
-   ABCC_AddCmdSeq( SetupSeqAfterUserInit, SetupDone );
+   abcc_bNumPendingSetupSeq = 2;
+   ABCC_AddCmdSeq( SetupSeqRdPdSize, PdSizeSeqDone );
+   ABCC_AddCmdSeq( SetupSeqWrPdSize, PdSizeSeqDone );
 }
 #else
 void  ABCC_StartSetup( void )
@@ -24,6 +24,9 @@
 ********************************************************************************
 ** File Description:
 ** Timer implementation.
+** Timers hold absolute deadlines against a free running millisecond counter
+** and the earliest deadline is cached, so a tick where nothing expires costs
+** a single compare, independent of the number of timers.
 ********************************************************************************
 ********************************************************************************
 */
@@ -49,7 +52,7 @@ typedef struct ABCC_TimerTimeoutType
 {
    BOOL  fActive;
    BOOL  fTmoOccured;
-   INT32 lTimeLeft;
+   UINT32 lDeadlineMs;
    ABCC_TimerTimeoutCallbackType pnHandleTimeout;
 }
 ABCC_TimerTimeoutType;
@@ -69,11 +72,69 @@ ABCC_TimerTimeoutType;
 static ABCC_TimerTimeoutType sTimer[ MAX_NUM_TIMERS ];
 static BOOL fTimerEnabled = FALSE;
 
+/*
+** Free running time base, advanced by ABCC_TimerTick(). Wraps after ~49 days,
+** so deadlines are always compared as signed differences.
+*/
+static UINT32 lTimerNowMs = 0;
+
+/*
+** Earliest deadline of all active timers. Only valid if fNextDeadlineValid.
+*/
+static UINT32 lNextDeadlineMs = 0;
+static BOOL fNextDeadlineValid = FALSE;
+
 /*******************************************************************************
 ** Private Services
 ********************************************************************************
 */
 
+/*------------------------------------------------------------------------------
+** Checks if the deadline has been reached at the current time.
+**------------------------------------------------------------------------------
+** Arguments:
+**    lDeadlineMs: Deadline to check.
+** Returns:
+**    TRUE if the deadline is reached or passed.
+**------------------------------------------------------------------------------
+*/
+static BOOL IsDeadlineReached( UINT32 lDeadlineMs )
+{
+   return( (INT32)( lDeadlineMs - lTimerNowMs ) <= 0 );
+}
+
+/*------------------------------------------------------------------------------
+** Recalculates the earliest deadline of the active timers. Only called when
+** the set of active timers changes, never on a plain tick.
+** Must be called within a critical section.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+static void UpdateNextDeadline( void )
+{
+   ABCC_TimerHandle xHandle;
+
+   fNextDeadlineValid = FALSE;
+
+   for ( xHandle = 0; xHandle < MAX_NUM_TIMERS; xHandle++ )
+   {
+      if ( ( sTimer[ xHandle ].pnHandleTimeout != NULL ) &&
+           ( sTimer[ xHandle ].fActive == TRUE ) )
+      {
+         if( !fNextDeadlineValid ||
+             ( (INT32)( sTimer[ xHandle ].lDeadlineMs - lNextDeadlineMs ) < 0 ) )
+         {
+            lNextDeadlineMs = sTimer[ xHandle ].lDeadlineMs;
+            fNextDeadlineValid = TRUE;
+         }
+      }
+   }
+}
+
 
 /*******************************************************************************
 ** Public Services
@@ -87,6 +148,7 @@ void ABCC_TimerInit( void )
    {
       sTimer[ xHandle ].pnHandleTimeout = NULL;
    }
+   fNextDeadlineValid = FALSE;
    fTimerEnabled = TRUE;
 }
 
@@ -130,9 +192,10 @@ BOOL ABCC_TimerStart( ABCC_TimerHandle xHandle,
 
    ABCC_PORT_EnterCritical();
    fTmo = sTimer[ xHandle ].fTmoOccured;
-   sTimer[ xHandle ].lTimeLeft = (INT32)lTimeoutMs;
+   sTimer[ xHandle ].lDeadlineMs = lTimerNowMs + lTimeoutMs;
    sTimer[ xHandle ].fTmoOccured = FALSE;
    sTimer[ xHandle ].fActive = TRUE;
+   UpdateNextDeadline();
 
    ABCC_PORT_ExitCritical();
    return( fTmo );
@@ -152,6 +215,7 @@ BOOL ABCC_TimerStop( ABCC_TimerHandle xHandle )
 
    sTimer[ xHandle ].fActive = FALSE;
    sTimer[ xHandle ].fTmoOccured = FALSE;
+   UpdateNextDeadline();
 
    ABCC_PORT_ExitCritical();
    return( fTmo );
@@ -163,6 +227,9 @@ BOOL ABCC_TimerStop( ABCC_TimerHandle xHandle )
 void ABCC_TimerTick(const INT16 iDeltaTimeMs)
 {
    ABCC_TimerHandle xHandle;
+   ABCC_TimerTimeoutCallbackType apnExpired[ MAX_NUM_TIMERS ];
+   UINT8 bNumExpired = 0;
+   UINT8 bIndex;
    ABCC_PORT_UseCritical();
 
    if( !fTimerEnabled )
@@ -172,22 +239,41 @@ void ABCC_TimerTick(const INT16 iDeltaTimeMs)
 
    ABCC_PORT_EnterCritical();
 
+   lTimerNowMs += (UINT32)iDeltaTimeMs;
+
+   /*
+   ** Fast path, nothing to expire on this tick.
+   */
+   if( !fNextDeadlineValid || !IsDeadlineReached( lNextDeadlineMs ) )
+   {
+      ABCC_PORT_ExitCritical();
+      return;
+   }
+
    for ( xHandle = 0; xHandle < MAX_NUM_TIMERS; xHandle++ )
    {
        if ( ( sTimer[ xHandle ].pnHandleTimeout != NULL ) &&
-             ( sTimer[ xHandle ].fActive == TRUE ) )
+             ( sTimer[ xHandle ].fActive == TRUE ) &&
+             IsDeadlineReached( sTimer[ xHandle ].lDeadlineMs ) )
        {
-          sTimer[ xHandle ].lTimeLeft -= (INT32)iDeltaTimeMs;
-          if( sTimer[ xHandle ].lTimeLeft <= 0 )
-          {
-             sTimer[ xHandle ].fTmoOccured = TRUE;
-             sTimer[ xHandle ].fActive = FALSE;
-             sTimer[ xHandle ].pnHandleTimeout();
-          }
+          sTimer[ xHandle ].fTmoOccured = TRUE;
+          sTimer[ xHandle ].fActive = FALSE;
+          apnExpired[ bNumExpired++ ] = sTimer[ xHandle ].pnHandleTimeout;
        }
    }
 
+   UpdateNextDeadline();
+
    ABCC_PORT_ExitCritical();
+
+   /*
+   ** Timeout handlers are called outside of the critical section, so they are
+   ** free to restart timers and do not prolong the interrupt latency.
+   */
+   for ( bIndex = 0; bIndex < bNumExpired; bIndex++ )
+   {
+      apnExpired[ bIndex ]();
+   }
 }
 
 void ABCC_TimerDisable( void )
@@ -34,6 +34,7 @@
 #include "abcc_td.h"
 #include "abcc.h"
 #include "abcc_sys_adapt.h"
+#include "abcc_crc32.h"
 
 const UINT16 aiBitReverseTable16[] = { 0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF };
 
@@ -53,11 +54,15 @@ const UINT32 crc_table32[] = { 0x4DBDF21CUL, 0x500AE278UL, 0x76D3D2D4UL, 0x6B64C
 */
 
 UINT32 CRC_Crc32( UINT16* piBufferStart, UINT16 iLength )
+{
+   return( CRC_Crc32Final( CRC_Crc32Update( 0x0, piBufferStart, iLength ) ) );
+}
+
+UINT32 CRC_Crc32Update( UINT32 lCrc, UINT16* piBufferStart, UINT16 iLength )
 {
    UINT16 iCrcReverseByte;
    UINT16 iCurrentWordVal;
    UINT16 i;
-   UINT32 lCrc = 0x0;
 
    for(i = 0; i < ( iLength >> 1 ); i++)
    {
@@ -77,6 +82,11 @@ UINT32 CRC_Crc32( UINT16* piBufferStart, UINT16 iLength )
       piBufferStart++;
    }
 
+   return( lCrc );
+}
+
+UINT32 CRC_Crc32Final( UINT32 lCrc )
+{
    lCrc = ( (UINT32)aiBitReverseTable16[ (lCrc & 0x000000F0UL ) >> 4 ] ) |
           ( (UINT32)aiBitReverseTable16[ (lCrc & 0x0000000FUL ) ] ) << 4 |
           ( (UINT32)aiBitReverseTable16[ (lCrc & 0x0000F000UL ) >> 12 ] << 8)  |
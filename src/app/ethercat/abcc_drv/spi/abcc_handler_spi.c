@@ -34,6 +34,7 @@
 
 #include "abcc_td.h"
 #include "../abcc_drv_if.h"
+#include "abcc_drv_spi_if.h"
 #include "abp.h"
 #include "abcc.h"
 #include "../abcc_link.h"
@@ -103,6 +104,20 @@ ABCC_ErrorCodeType ABCC_SpiRunDriver( void )
    */
    ABCC_LinkRunDriverRx();
 
+#if( ABCC_CFG_INT_ENABLED )
+   /*
+   ** The received MISO frame stays in its own buffer during the next
+   ** transfer, so start the next transfer right away, if there is anything to
+   ** send, and deliver the received data while it is ongoing.
+   */
+   if( !ABCC_DrvSpiIsTransferOngoing() && ABCC_IsRunDriverPending() )
+   {
+      ABCC_CheckWrPdUpdate();
+      ABCC_LinkCheckSendMessage();
+      pnABCC_DrvRunDriverTx();
+   }
+#endif
+
    ABCC_TriggerRdPdUpdate();
    ABCC_TriggerAnbStatusUpdate();
    ABCC_TriggerReceiveMessage();
@@ -128,6 +143,13 @@ void ABCC_SpiISR()
    if ( eMainState == ABCC_DRV_WAIT_COMMUNICATION_RDY )
    {
       ABCC_SetReadyForCommunication();
+
+      /*
+      ** No event to handle yet. Only let the application know that the
+      ** ABCC is ready, so it does not have to poll
+      ** ABCC_isReadyForCommunication().
+      */
+      ABCC_CbfEvent( 0 );
       return;
    }
 
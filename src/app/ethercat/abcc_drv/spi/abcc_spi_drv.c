@@ -107,6 +107,19 @@ static const UINT16 iSpiStatusNewPd =     ABP_SPI_STATUS_NEW_PD << 8;
 #if ABCC_CFG_SPI_MSG_FRAG_LEN > ABCC_CFG_MAX_MSG_SIZE
 #error  spi fragmentation length cannot exceed max msg size
 #endif
+#if ABCC_CFG_SPI_MSG_FRAG_LEN_CYCLIC > ABCC_CFG_SPI_MSG_FRAG_LEN
+#error  cyclic spi fragmentation length cannot exceed spi fragmentation length
+#endif
+#if ABCC_CFG_SPI_MSG_FRAG_LEN_CYCLIC < 2
+#error  cyclic spi fragmentation length must hold at least one word
+#endif
+
+/*
+** Size of a message buffer in words. Rounded up, so the last octet of a
+** message of odd max size is kept. The buffers of abcc_mem.c round their data
+** up to whole 32-bit words, so the copy still ends within the buffer.
+*/
+#define MSG_BUFFER_WORD_LEN ( ( ABCC_CFG_MAX_MSG_SIZE + ABCC_MSG_HEADER_TYPE_SIZEOF + 1 ) >> 1 )
 #define MAX_PAYLOAD_WORD_LEN ( ( NUM_BYTES_2_WORDS( ABCC_CFG_SPI_MSG_FRAG_LEN ) ) + ( NUM_BYTES_2_WORDS( ABCC_CFG_MAX_PROCESS_DATA_SIZE ) ) + ( CRC_WORD_LEN_IN_WORDS ) )
 
 
@@ -114,6 +127,8 @@ static const UINT16 iSpiStatusNewPd =     ABP_SPI_STATUS_NEW_PD << 8;
 #define INSERT_SPI_CTRL_CMDCNT( ctrl, cmdcnt)  ctrl = ( ( ctrl ) & ~iSpiCtrlCmdCnt ) | ( ( cmdcnt ) << iSpiCtrlCmdCntShift )
 #define EXTRACT_SPI_STATUS_CMDCNT( status ) ( ( ( status ) & iSpiStatusCmdCnt ) >> iSpiStatusCmdCntShift )
 #define SPI_BASE_FRAME_WORD_LEN  5 /* Frame length excluding MSG and PD data */
+#define SPI_MOSI_HEADER_WORD_LEN 4 /* MOSI frame length preceding the MSG data */
+#define SPI_MISO_HEADER_WORD_LEN 5 /* MISO frame length preceding the MSG data */
 
 
 /*******************************************************************************
@@ -195,7 +210,8 @@ typedef enum
 ** MISO privates.
 **------------------------------------------------------------------------------
 */
-static drv_SpiMisoFrameType         spi_drv_sMisoFrame;           /* Place holder for the MISO frame. */
+static drv_SpiMisoFrameType         spi_drv_asMisoFrame[ 2 ];     /* Ping-pong buffers for the MISO frame. */
+static drv_SpiMisoFrameType*        spi_drv_psMisoFrame;          /* MISO frame of the ongoing or latest transfer. */
 static drv_SpiReadMsgFragInfoType   spi_drv_sReadFragInfo;        /* Read message info. */
 static BOOL                         spi_drv_fNewMisoReceived;     /* MISO received flag. */
 static UINT8                        spi_drv_bAnbStatus;           /* Latest received anb status. */
@@ -211,13 +227,31 @@ static ABP_MsgType*                 spi_drv_psReadMessage;        /* Pointer to
 ** MOSI privates.
 **------------------------------------------------------------------------------
 */
-static drv_SpiMosiFrameType         spi_drv_sMosiFrame;           /* Place holder for the MISO frame. */
+static drv_SpiMosiFrameType         spi_drv_asMosiFrame[ 2 ];     /* Ping-pong buffers for the MOSI frame. */
+static drv_SpiMosiFrameType*        spi_drv_psMosiFrame;          /* MOSI frame being built for the next transfer. */
+static drv_SpiMosiFrameType*        spi_drv_psSentMosiFrame;      /* MOSI frame of the ongoing or latest transfer. */
+static UINT16                       spi_drv_iSpiControl;          /* SPI control word kept between MOSI frames. */
+static UINT8                        spi_drv_bSentAppStatus;       /* Appstatus sent in the latest MOSI frame. */
+static UINT8                        spi_drv_bSentIntMask;         /* Intmask sent in the latest MOSI frame. */
 static drv_SpiWriteMsgFragInfoType  spi_drv_sWriteFragInfo;       /* Write message info. */
 static UINT8                        spi_drv_bNbrOfCmds;           /* Number of commands support by the application. */
 static UINT8                        spi_drv_bNextAppStatus;       /* Appstatus to be sent in next MOSI frame */
 static UINT8                        spi_drv_bNextIntMask;         /* Intmask to be sent in next MOSI frame */
 
 
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+/*------------------------------------------------------------------------------
+** Segments of the frames of the ongoing or latest transfer.
+**------------------------------------------------------------------------------
+*/
+static ABCC_SYS_SpiSegmentType      spi_drv_asMosiSegments[ ABCC_SYS_SPI_MAX_NUM_SEGMENTS ]; /* MOSI frame segments. */
+static UINT8                        spi_drv_bNumMosiSegments;     /* Number of MOSI frame segments. */
+static ABCC_SYS_SpiSegmentType      spi_drv_asMisoSegments[ ABCC_SYS_SPI_MAX_NUM_SEGMENTS ]; /* MISO frame segments. */
+static UINT8                        spi_drv_bNumMisoSegments;     /* Number of MISO frame segments. */
+static UINT16                       spi_drv_iMisoMsgWordLen;      /* Message words received straight into the read message buffer. */
+#endif
+
+
 /*------------------------------------------------------------------------------
 ** General privates.
 **------------------------------------------------------------------------------
@@ -228,6 +262,9 @@ static UINT16                       spi_drv_iCrcOffset;           /* Offset in p
 static UINT16                       spi_drv_iPdSize;              /* PD size in spiFrame. */
 static UINT16                       spi_drv_iWritePdSize;         /* Current write PD size. */
 static UINT16                       spi_drv_iReadPdSize;          /* Current read PD size. */
+static UINT16                       spi_drv_iNextWritePdSize;     /* Write PD size to be used from the next MOSI frame. */
+static UINT16                       spi_drv_iNextReadPdSize;      /* Read PD size to be used from the next MOSI frame. */
+static BOOL                         spi_drv_fNewPdSize;           /* New PD sizes are waiting for the next MOSI frame. */
 
 static UINT16                       spi_drv_iSpiFrameSize;        /* Current Spi frame size. */
 static BOOL                         spi_drv_fRetransmit;          /* Indicate retransmission. */
@@ -237,6 +274,9 @@ static ABCC_TimerHandle             xWdTmoHandle;
 static BOOL                         fWdTmo;                       /* Current wd timeout status */
 
 static UINT16                       spi_drv_iMsgLen;              /* Message length ( in words ) */
+#if( ABCC_CFG_SPI_PD_PRIORITY )
+static BOOL                         spi_drv_fPdOnlyFrameSent;     /* Latest MOSI frame was sent without message field. */
+#endif
 
 
 
@@ -251,6 +291,17 @@ static void spi_drv_ResetReadFragInfo( void );
 static void spi_drv_ResetWriteFragInfo( void );
 
 static void DrvSpiSetMsgReceiverBuffer( ABP_MsgType* const psReadMsg );
+static UINT16 spi_drv_SelectMsgLen( void );
+static void spi_drv_SetMsgLen( UINT16 iMsgLen );
+static void spi_drv_ApplyPdSize( void );
+static void spi_drv_SwapMosiFrame( void );
+static drv_SpiMisoFrameType* spi_drv_SwapMisoFrame( drv_SpiMisoFrameType* psMisoFrame );
+static void spi_drv_SendReceive( void );
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+static void spi_drv_SetupMosiSegments( UINT16 iFragLength );
+static void spi_drv_SetupMisoSegments( void );
+static UINT32 spi_drv_SegmentsCrc32( const ABCC_SYS_SpiSegmentType* psSegments, UINT16 iLength );
+#endif
 
 
 /*******************************************************************************
@@ -276,6 +327,7 @@ void ABCC_DrvSpiRunDriverTx( void )
    UINT32 lCrc;
    BOOL   fHandleWriteMsg = FALSE;
    UINT16 iRdyForCmd;
+   UINT16 iMsgLen;
 
    ABCC_PORT_UseCritical();
 
@@ -283,22 +335,49 @@ void ABCC_DrvSpiRunDriverTx( void )
    {
       spi_drv_eState = SM_SPI_WAITING_FOR_MISO;
 
-      if ( !spi_drv_fRetransmit )
+      if ( spi_drv_fRetransmit )
       {
          /*
-         ** Everything is OK. Reset retransmission and toggle the T bit.
+         ** The previous frame was not received correctly. It is still intact
+         ** in its own buffer, so send it again as it is, with the same T bit.
+         ** The corrupt MISO buffer is reused, the other one may still hold
+         ** unread process data.
          */
-         spi_drv_sMosiFrame.iSpiControl ^= iSpiCtrl_T;
+         spi_drv_fRetransmit = FALSE;
+         spi_drv_SendReceive();
+         return;
+      }
+
+      /*
+      ** Take new process data sizes into use. The frame received last has
+      ** already been checked with the layout it was sent with.
+      */
+      if( spi_drv_fNewPdSize )
+      {
+         spi_drv_ApplyPdSize();
+      }
+
+      /*
+      ** Adapt the message fragment length. The write process data in the
+      ** frame being built is moved along with it.
+      */
+      iMsgLen = spi_drv_SelectMsgLen();
+      if( iMsgLen != spi_drv_iMsgLen )
+      {
+         spi_drv_SetMsgLen( iMsgLen );
       }
 
-      spi_drv_fRetransmit = FALSE;
+      /*
+      ** Everything is OK. Toggle the T bit.
+      */
+      spi_drv_iSpiControl ^= iSpiCtrl_T;
 
       /*---------------------------------------------------------------------------
       ** Write message handling.
       **---------------------------------------------------------------------------
       */
       ABCC_PORT_EnterCritical();
-      if (spi_drv_sWriteFragInfo.psWriteMsg != NULL )
+      if ( ( spi_drv_sWriteFragInfo.psWriteMsg != NULL ) && ( spi_drv_iMsgLen != 0 ) )
       {
          fHandleWriteMsg = TRUE;
       }
@@ -312,11 +391,11 @@ void ABCC_DrvSpiRunDriverTx( void )
          /*
          ** Write the message to be sent.
          */
-         spi_drv_sMosiFrame.iSpiControl |= iSpiCtrl_M;
+         spi_drv_iSpiControl |= iSpiCtrl_M;
 
          if( spi_drv_sWriteFragInfo.iNumWordsLeft <= spi_drv_iMsgLen )
          {
-            spi_drv_sMosiFrame.iSpiControl |= iSpiCtrlLastFrag;
+            spi_drv_iSpiControl |= iSpiCtrlLastFrag;
             spi_drv_sWriteFragInfo.iCurrFragLength = spi_drv_sWriteFragInfo.iNumWordsLeft;
          }
          else
@@ -324,24 +403,26 @@ void ABCC_DrvSpiRunDriverTx( void )
             /*
             ** This is not the last fragment.
             */
-            spi_drv_sMosiFrame.iSpiControl &= ~iSpiCtrlLastFrag;
+            spi_drv_iSpiControl &= ~iSpiCtrlLastFrag;
             spi_drv_sWriteFragInfo.iCurrFragLength = spi_drv_iMsgLen;
          }
 
+#if( !ABCC_CFG_SPI_MSG_ZERO_COPY )
          /*
          ** Copy the message into the MOSI frame buffer.
          */
-         ABCC_PORT_MemCpy( (void*)spi_drv_sMosiFrame.iData,
+         ABCC_PORT_MemCpy( (void*)spi_drv_psMosiFrame->iData,
                            (void*)spi_drv_sWriteFragInfo.puCurrPtr,
                            spi_drv_sWriteFragInfo.iCurrFragLength << 1 );
+#endif
       }
       else
       {
          /*
          ** There is no message fragment to be sent.
          */
-         spi_drv_sMosiFrame.iSpiControl &= ~iSpiCtrl_M;
-         spi_drv_sMosiFrame.iSpiControl &= ~iSpiCtrlLastFrag;
+         spi_drv_iSpiControl &= ~iSpiCtrl_M;
+         spi_drv_iSpiControl &= ~iSpiCtrlLastFrag;
       }
 
       iRdyForCmd = 0;
@@ -353,27 +434,69 @@ void ABCC_DrvSpiRunDriverTx( void )
       {
          iRdyForCmd =  spi_drv_bNbrOfCmds & 0x3;
       }
-      INSERT_SPI_CTRL_CMDCNT(spi_drv_sMosiFrame.iSpiControl, iRdyForCmd );
+      INSERT_SPI_CTRL_CMDCNT(spi_drv_iSpiControl, iRdyForCmd );
 
+      /*
+      ** The valid write PD flag belongs to this frame only. Process data
+      ** written during the transfer marks the next frame.
+      */
+      spi_drv_psMosiFrame->iSpiControl = spi_drv_iSpiControl;
+#if( ABCC_CFG_SPI_PD_PRIORITY )
+      spi_drv_fPdOnlyFrameSent = ( spi_drv_iMsgLen == 0 );
+      if( spi_drv_iSpiControl & iSpiCtrlWrPdWalid )
+      {
+         ABCC_CbfSpiSchedEvent( ABCC_SPI_SCHED_PD_FRAME );
+      }
+      if( fHandleWriteMsg && ( spi_drv_iSpiControl & iSpiCtrlLastFrag ) )
+      {
+         ABCC_CbfSpiSchedEvent( ABCC_SPI_SCHED_MSG_SENT );
+      }
+#endif
+      spi_drv_iSpiControl &= ~iSpiCtrlWrPdWalid;
 
-      ABCC_SetLowAddrOct( spi_drv_sMosiFrame.iIntMaskAppStatus, spi_drv_bNextAppStatus );
-      ABCC_SetHighAddrOct( spi_drv_sMosiFrame.iIntMaskAppStatus, spi_drv_bNextIntMask );
-      spi_drv_bpRdPd = NULL;
+      spi_drv_psMosiFrame->iMsgLen = iTOiLe( spi_drv_iMsgLen );
+      spi_drv_psMosiFrame->iPdLen = iTOiLe( spi_drv_iPdSize );
+      ABCC_SetLowAddrOct( spi_drv_psMosiFrame->iIntMaskAppStatus, spi_drv_bNextAppStatus );
+      ABCC_SetHighAddrOct( spi_drv_psMosiFrame->iIntMaskAppStatus, spi_drv_bNextIntMask );
+      spi_drv_bSentAppStatus = spi_drv_bNextAppStatus;
+      spi_drv_bSentIntMask = spi_drv_bNextIntMask;
 
 
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+      /*
+      ** The message fragment is not copied into the MOSI frame buffer, it is
+      ** sent straight from the message buffer.
+      */
+      spi_drv_SetupMosiSegments( fHandleWriteMsg ? spi_drv_sWriteFragInfo.iCurrFragLength : 0 );
+
       /*
       ** Apply the CRC checksum.
       */
-      lCrc = CRC_Crc32( (UINT16*)&spi_drv_sMosiFrame, spi_drv_iSpiFrameSize*2 - 6 );
+      lCrc = spi_drv_SegmentsCrc32( spi_drv_asMosiSegments, spi_drv_iSpiFrameSize*2 - 6 );
+#else
+      /*
+      ** Apply the CRC checksum.
+      */
+      lCrc = CRC_Crc32( (UINT16*)spi_drv_psMosiFrame, spi_drv_iSpiFrameSize*2 - 6 );
+#endif
       lCrc = lTOlLe( lCrc );
 
-      ABCC_PORT_MemCpy( &spi_drv_sMosiFrame.iData[ spi_drv_iCrcOffset ],
+      ABCC_PORT_MemCpy( &spi_drv_psMosiFrame->iData[ spi_drv_iCrcOffset ],
                         &lCrc,
                         ABP_UINT32_SIZEOF );
+
+      /*
+      ** Hand the frame over to the transfer and continue building in the
+      ** other buffer. The MISO frame received last stays untouched, so its
+      ** process data may be read while this transfer is ongoing.
+      */
+      spi_drv_SwapMosiFrame();
+      spi_drv_psMisoFrame = spi_drv_SwapMisoFrame( spi_drv_psMisoFrame );
+
       /*
       ** Send the MOSI frame.
       */
-      ABCC_SYS_SpiSendReceive( &spi_drv_sMosiFrame, &spi_drv_sMisoFrame, spi_drv_iSpiFrameSize << 1 );
+      spi_drv_SendReceive();
    }
    else if ( spi_drv_eState == SM_SPI_INIT )
    {
@@ -413,13 +536,32 @@ ABP_MsgType* ABCC_DrvSpiRunDriverRx( void )
          spi_drv_fNewMisoReceived = FALSE;
       }
 
-      lCalculatedCrc = CRC_Crc32( (UINT16*)&spi_drv_sMisoFrame, spi_drv_iSpiFrameSize*2 - 4 );
+#if( ABCC_CFG_SPI_16_BIT_FRAMES )
+      /*
+      ** Octets of 16-bit SPI frames are swapped for the transfer. Bring both
+      ** frames back to memory order here, not in the transfer interrupt.
+      */
+      ABCC_SYS_SpiFinishTransfer();
+#endif
+
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+      lCalculatedCrc = spi_drv_SegmentsCrc32( spi_drv_asMisoSegments, spi_drv_iSpiFrameSize*2 - 4 );
+#else
+      lCalculatedCrc = CRC_Crc32( (UINT16*)spi_drv_psMisoFrame, spi_drv_iSpiFrameSize*2 - 4 );
+#endif
       lCalculatedCrc = lLeTOl( lCalculatedCrc );
 
       ABCC_PORT_MemCpy( &lRecievedCrc,
-                        &spi_drv_sMisoFrame.iData[ spi_drv_iCrcOffset ],
+                        &spi_drv_psMisoFrame->iData[ spi_drv_iCrcOffset ],
                         ABP_UINT32_SIZEOF );
 
+#if( ABCC_CFG_SPI_CLOCK_FALLBACK )
+      /*
+      ** The system adaption layer may lower the SPI clock on repeated errors.
+      */
+      ABCC_SYS_SpiFrameCrcChecked( lCalculatedCrc == lRecievedCrc );
+#endif
+
       if( lCalculatedCrc != lRecievedCrc )
       {
          /*
@@ -442,21 +584,25 @@ ABP_MsgType* ABCC_DrvSpiRunDriverRx( void )
       fWdTmo = FALSE;
       ABCC_TimerStart( xWdTmoHandle, ABCC_CFG_WD_TIMEOUT_MS );
 
+      /*
+      ** Process data not read from the previous MISO frame is outdated now.
+      */
+      spi_drv_bpRdPd = NULL;
 
       /*
       ** Save the current anybus status.
       */
-      spi_drv_bAnbStatus =  ABCC_GetLowAddrOct( spi_drv_sMisoFrame.iSpiStatusAnbStatus );
-      spi_drv_iLedStatus  = iLeTOi( spi_drv_sMisoFrame.iLedStat );
+      spi_drv_bAnbStatus =  ABCC_GetLowAddrOct( spi_drv_psMisoFrame->iSpiStatusAnbStatus );
+      spi_drv_iLedStatus  = iLeTOi( spi_drv_psMisoFrame->iLedStat );
 
-      spi_drv_bAnbCmdCnt = (UINT8)EXTRACT_SPI_STATUS_CMDCNT( spi_drv_sMisoFrame.iSpiStatusAnbStatus  );
+      spi_drv_bAnbCmdCnt = (UINT8)EXTRACT_SPI_STATUS_CMDCNT( spi_drv_psMisoFrame->iSpiStatusAnbStatus  );
 
-      if( spi_drv_sMisoFrame.iSpiStatusAnbStatus & iSpiStatusNewPd )
+      if( spi_drv_psMisoFrame->iSpiStatusAnbStatus & iSpiStatusNewPd )
       {
          /*
          ** Report the new process data.
          */
-         spi_drv_bpRdPd = (UINT8*)&spi_drv_sMisoFrame.iData[ spi_drv_iPdOffset ];
+         spi_drv_bpRdPd = (UINT8*)&spi_drv_psMisoFrame->iData[ spi_drv_iPdOffset ];
       }
 
       /*---------------------------------------------------------------------------
@@ -468,7 +614,7 @@ ABP_MsgType* ABCC_DrvSpiRunDriverRx( void )
          /*
          ** Write the message to be sent.
          */
-         if( !( spi_drv_sMisoFrame.iSpiStatusAnbStatus & iSpiStatusWrMsgFull ) )
+         if( !( spi_drv_psMisoFrame->iSpiStatusAnbStatus & iSpiStatusWrMsgFull ) )
          {
             /*
             ** Write message was received.
@@ -496,7 +642,7 @@ ABP_MsgType* ABCC_DrvSpiRunDriverRx( void )
       ** Read message handling
       ** --------------------------------------------------------------------------
       */
-      if( spi_drv_sMisoFrame.iSpiStatusAnbStatus & iSpiStatus_M )
+      if( spi_drv_psMisoFrame->iSpiStatusAnbStatus & iSpiStatus_M )
       {
          /*
          ** Read message was received.
@@ -514,21 +660,39 @@ ABP_MsgType* ABCC_DrvSpiRunDriverRx( void )
             }
          }
 
-         if( ( ( spi_drv_sReadFragInfo.iNumWordsReceived + spi_drv_iMsgLen ) << 1 ) <=
-             ( ABCC_CFG_MAX_MSG_SIZE + ABCC_MSG_HEADER_TYPE_SIZEOF ) )
+         if( spi_drv_sReadFragInfo.iNumWordsReceived < MSG_BUFFER_WORD_LEN )
          {
+            UINT16 iCopyLen;
+
             /*
-            ** Message fits in buffer so read it.
+            ** Read as much of the fragment as fits in the buffer. The last
+            ** fragment is padded up to the fragment length, so with large
+            ** fragments it may be longer than the space left.
             */
-            ABCC_PORT_MemCpy( spi_drv_sReadFragInfo.puCurrPtr,
-                              spi_drv_sMisoFrame.iData,
-                              spi_drv_iMsgLen << 1 );
+            iCopyLen = MSG_BUFFER_WORD_LEN - spi_drv_sReadFragInfo.iNumWordsReceived;
+            if( iCopyLen > spi_drv_iMsgLen )
+            {
+               iCopyLen = spi_drv_iMsgLen;
+            }
+
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+            /*
+            ** The fragment has already been received straight into the buffer,
+            ** unless no buffer was available when the transfer was started.
+            */
+            if( spi_drv_iMisoMsgWordLen == 0 )
+#endif
+            {
+               ABCC_PORT_MemCpy( spi_drv_sReadFragInfo.puCurrPtr,
+                                 spi_drv_psMisoFrame->iData,
+                                 iCopyLen << 1 );
+            }
 
-            spi_drv_sReadFragInfo.puCurrPtr += spi_drv_iMsgLen;
-            spi_drv_sReadFragInfo.iNumWordsReceived += spi_drv_iMsgLen;
+            spi_drv_sReadFragInfo.puCurrPtr += iCopyLen;
+            spi_drv_sReadFragInfo.iNumWordsReceived += iCopyLen;
          }
 
-         if( spi_drv_sMisoFrame.iSpiStatusAnbStatus & iSpiStatusLastFrag )
+         if( spi_drv_psMisoFrame->iSpiStatusAnbStatus & iSpiStatusLastFrag )
          {
             /*
             ** Last fragment of the read message. Return the message.
@@ -544,10 +708,6 @@ ABP_MsgType* ABCC_DrvSpiRunDriverRx( void )
          }
       }
 
-      /*
-      ** Clear the valid pd for the next frame.
-      */
-      spi_drv_sMosiFrame.iSpiControl &= ~iSpiCtrlWrPdWalid;
       spi_drv_eState = SM_SPI_RDY_TO_SEND_MOSI;
    }
    else if( spi_drv_eState == SM_SPI_INIT )
@@ -616,6 +776,330 @@ static void spi_drv_ResetWriteFragInfo( void )
 }
 
 
+/*------------------------------------------------------------------------------
+** Selects the message fragment length for the next MOSI frame.
+** While the ABCC is starting up or not exchanging process data, long fragments
+** are used, so setup and enumeration messages take few transactions. In
+** PROCESS_ACTIVE short fragments keep the transaction time, and thereby the
+** process data latency, low.
+** The length is only changed at message boundaries and never for a
+** retransmission.
+**------------------------------------------------------------------------------
+** Arguments:
+**       None.
+**
+** Returns:
+**       Message fragment length in words.
+**------------------------------------------------------------------------------
+*/
+static UINT16 spi_drv_SelectMsgLen( void )
+{
+   if( spi_drv_fRetransmit ||
+       ( spi_drv_sReadFragInfo.iNumWordsReceived != 0 ) ||
+       ( ( spi_drv_sWriteFragInfo.psWriteMsg != NULL ) &&
+         ( spi_drv_sWriteFragInfo.puCurrPtr != (UINT16*)spi_drv_sWriteFragInfo.psWriteMsg ) ) )
+   {
+      return( spi_drv_iMsgLen );
+   }
+
+   if( ( spi_drv_bAnbStatus & 0x7 ) == ABP_ANB_STATE_PROCESS_ACTIVE )
+   {
+#if( ABCC_CFG_SPI_PD_PRIORITY )
+      /*
+      ** A frame with new write process data is sent without message field,
+      ** so it is as short as possible. Messages in both directions wait for
+      ** the next frame, which always has the message field, so they are
+      ** delayed by one frame at most.
+      */
+      if( ( spi_drv_iSpiControl & iSpiCtrlWrPdWalid ) && !spi_drv_fPdOnlyFrameSent )
+      {
+         return( 0 );
+      }
+#endif
+      return( NUM_BYTES_2_WORDS( ABCC_CFG_SPI_MSG_FRAG_LEN_CYCLIC ) );
+   }
+
+   return( NUM_BYTES_2_WORDS( ABCC_CFG_SPI_MSG_FRAG_LEN ) );
+}
+
+
+/*------------------------------------------------------------------------------
+** Changes the message fragment length. The process data follows the message
+** field, so the write process data already in the MOSI frame being built is
+** moved to its new position.
+**------------------------------------------------------------------------------
+** Arguments:
+**       iMsgLen: New message fragment length in words.
+**
+** Returns:
+**       None.
+**------------------------------------------------------------------------------
+*/
+static void spi_drv_SetMsgLen( UINT16 iMsgLen )
+{
+   UINT16 i;
+
+   if( iMsgLen > spi_drv_iPdOffset )
+   {
+      for( i = spi_drv_iPdSize; i > 0; i-- )
+      {
+         spi_drv_psMosiFrame->iData[ iMsgLen + i - 1 ] =
+            spi_drv_psMosiFrame->iData[ spi_drv_iPdOffset + i - 1 ];
+      }
+   }
+   else
+   {
+      for( i = 0; i < spi_drv_iPdSize; i++ )
+      {
+         spi_drv_psMosiFrame->iData[ iMsgLen + i ] =
+            spi_drv_psMosiFrame->iData[ spi_drv_iPdOffset + i ];
+      }
+   }
+
+   spi_drv_iMsgLen = iMsgLen;
+   spi_drv_iPdOffset = iMsgLen;
+   spi_drv_iCrcOffset = spi_drv_iPdOffset + spi_drv_iPdSize;
+   spi_drv_iSpiFrameSize = SPI_FRAME_SIZE_EXCLUDING_DATA + spi_drv_iCrcOffset;
+}
+
+
+/*------------------------------------------------------------------------------
+** Takes the latched process data sizes into use and updates the CRC position
+** and the total frame size accordingly.
+**------------------------------------------------------------------------------
+** Arguments:
+**       None.
+**
+** Returns:
+**       None.
+**------------------------------------------------------------------------------
+*/
+static void spi_drv_ApplyPdSize( void )
+{
+   spi_drv_fNewPdSize = FALSE;
+   spi_drv_iWritePdSize = spi_drv_iNextWritePdSize;
+   spi_drv_iReadPdSize = spi_drv_iNextReadPdSize;
+
+   /*
+   ** Use the largest PD data size since the PD cannot be fragmented.
+   */
+   spi_drv_iPdSize = spi_drv_iWritePdSize;
+   if( spi_drv_iReadPdSize > spi_drv_iWritePdSize )
+   {
+      spi_drv_iPdSize = spi_drv_iReadPdSize;
+   }
+
+   spi_drv_iCrcOffset = spi_drv_iPdOffset + spi_drv_iPdSize;
+   spi_drv_iSpiFrameSize = SPI_FRAME_SIZE_EXCLUDING_DATA + spi_drv_iCrcOffset;
+}
+
+
+/*------------------------------------------------------------------------------
+** Swaps the MOSI ping-pong buffers. The frame just built becomes the one being
+** sent and the write process data is carried over to the other buffer, which
+** becomes the frame being built.
+**------------------------------------------------------------------------------
+** Arguments:
+**       None.
+**
+** Returns:
+**       None.
+**------------------------------------------------------------------------------
+*/
+static void spi_drv_SwapMosiFrame( void )
+{
+   spi_drv_psSentMosiFrame = spi_drv_psMosiFrame;
+
+   if( spi_drv_psMosiFrame == &spi_drv_asMosiFrame[ 0 ] )
+   {
+      spi_drv_psMosiFrame = &spi_drv_asMosiFrame[ 1 ];
+   }
+   else
+   {
+      spi_drv_psMosiFrame = &spi_drv_asMosiFrame[ 0 ];
+   }
+
+   /*
+   ** The application may update only part of the process data, so start from
+   ** the data just sent.
+   */
+   ABCC_PORT_MemCpy( &spi_drv_psMosiFrame->iData[ spi_drv_iPdOffset ],
+                     &spi_drv_psSentMosiFrame->iData[ spi_drv_iPdOffset ],
+                     spi_drv_iPdSize << 1 );
+}
+
+
+/*------------------------------------------------------------------------------
+** Returns the MISO ping-pong buffer other than the given one.
+**------------------------------------------------------------------------------
+** Arguments:
+**       psMisoFrame: MISO frame buffer.
+**
+** Returns:
+**       The other MISO frame buffer.
+**------------------------------------------------------------------------------
+*/
+static drv_SpiMisoFrameType* spi_drv_SwapMisoFrame( drv_SpiMisoFrameType* psMisoFrame )
+{
+   if( psMisoFrame == &spi_drv_asMisoFrame[ 0 ] )
+   {
+      return( &spi_drv_asMisoFrame[ 1 ] );
+   }
+
+   return( &spi_drv_asMisoFrame[ 0 ] );
+}
+
+
+/*------------------------------------------------------------------------------
+** Starts the transfer of the latest MOSI frame, receiving into the current MISO
+** frame buffer.
+**------------------------------------------------------------------------------
+** Arguments:
+**       None.
+**
+** Returns:
+**       None.
+**------------------------------------------------------------------------------
+*/
+static void spi_drv_SendReceive( void )
+{
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+   spi_drv_SetupMisoSegments();
+
+   ABCC_SYS_SpiSendReceiveSegments( spi_drv_asMosiSegments, spi_drv_bNumMosiSegments,
+                                    spi_drv_asMisoSegments, spi_drv_bNumMisoSegments );
+#else
+   ABCC_SYS_SpiSendReceive( spi_drv_psSentMosiFrame, spi_drv_psMisoFrame, spi_drv_iSpiFrameSize << 1 );
+#endif
+}
+
+
+#if( ABCC_CFG_SPI_MSG_ZERO_COPY )
+/*------------------------------------------------------------------------------
+** Splits the MOSI frame being built into segments. With a message fragment to
+** be sent, the frame header is followed by the fragment in the message buffer
+** and then by the rest of the frame, starting with the unused part of the
+** message field.
+**------------------------------------------------------------------------------
+** Arguments:
+**       iFragLength: Length of the message fragment in words, 0 if none.
+**
+** Returns:
+**       None.
+**------------------------------------------------------------------------------
+*/
+static void spi_drv_SetupMosiSegments( UINT16 iFragLength )
+{
+   const UINT16 iFrameLength = spi_drv_iSpiFrameSize << 1;
+
+   spi_drv_asMosiSegments[ 0 ].pxData = spi_drv_psMosiFrame;
+
+   if( iFragLength == 0 )
+   {
+      spi_drv_asMosiSegments[ 0 ].iLength = iFrameLength;
+      spi_drv_bNumMosiSegments = 1;
+      return;
+   }
+
+   spi_drv_asMosiSegments[ 0 ].iLength = SPI_MOSI_HEADER_WORD_LEN << 1;
+   spi_drv_asMosiSegments[ 1 ].pxData = spi_drv_sWriteFragInfo.puCurrPtr;
+   spi_drv_asMosiSegments[ 1 ].iLength = iFragLength << 1;
+   spi_drv_asMosiSegments[ 2 ].pxData = &spi_drv_psMosiFrame->iData[ iFragLength ];
+   spi_drv_asMosiSegments[ 2 ].iLength = iFrameLength - ( ( SPI_MOSI_HEADER_WORD_LEN + iFragLength ) << 1 );
+   spi_drv_bNumMosiSegments = 3;
+}
+
+
+/*------------------------------------------------------------------------------
+** Splits the MISO frame buffer into segments, so that a message fragment is
+** received straight into the read message buffer. The buffer is allocated
+** before it is known if a message is received. Without a message only the
+** part of the buffer not received yet is written, which the next fragment
+** overwrites.
+**------------------------------------------------------------------------------
+** Arguments:
+**       None.
+**
+** Returns:
+**       None.
+**------------------------------------------------------------------------------
+*/
+static void spi_drv_SetupMisoSegments( void )
+{
+   const UINT16 iFrameLength = spi_drv_iSpiFrameSize << 1;
+
+   if( spi_drv_sReadFragInfo.puCurrPtr == NULL )
+   {
+      DrvSpiSetMsgReceiverBuffer( ABCC_MemAlloc() );
+   }
+
+   /*
+   ** As in ABCC_DrvSpiRunDriverRx(), only as much of the fragment as fits in
+   ** the buffer goes there.
+   */
+   spi_drv_iMisoMsgWordLen = 0;
+   if( ( spi_drv_sReadFragInfo.puCurrPtr != NULL ) &&
+       ( spi_drv_sReadFragInfo.iNumWordsReceived < MSG_BUFFER_WORD_LEN ) )
+   {
+      spi_drv_iMisoMsgWordLen = MSG_BUFFER_WORD_LEN - spi_drv_sReadFragInfo.iNumWordsReceived;
+      if( spi_drv_iMisoMsgWordLen > spi_drv_iMsgLen )
+      {
+         spi_drv_iMisoMsgWordLen = spi_drv_iMsgLen;
+      }
+   }
+
+   spi_drv_asMisoSegments[ 0 ].pxData = spi_drv_psMisoFrame;
+
+   if( spi_drv_iMisoMsgWordLen == 0 )
+   {
+      spi_drv_asMisoSegments[ 0 ].iLength = iFrameLength;
+      spi_drv_bNumMisoSegments = 1;
+      return;
+   }
+
+   spi_drv_asMisoSegments[ 0 ].iLength = SPI_MISO_HEADER_WORD_LEN << 1;
+   spi_drv_asMisoSegments[ 1 ].pxData = spi_drv_sReadFragInfo.puCurrPtr;
+   spi_drv_asMisoSegments[ 1 ].iLength = spi_drv_iMisoMsgWordLen << 1;
+   spi_drv_asMisoSegments[ 2 ].pxData = &spi_drv_psMisoFrame->iData[ spi_drv_iMisoMsgWordLen ];
+   spi_drv_asMisoSegments[ 2 ].iLength = iFrameLength - ( ( SPI_MISO_HEADER_WORD_LEN + spi_drv_iMisoMsgWordLen ) << 1 );
+   spi_drv_bNumMisoSegments = 3;
+}
+
+
+/*------------------------------------------------------------------------------
+** Calculates the CRC32 checksum over the first bytes of a segmented frame.
+**------------------------------------------------------------------------------
+** Arguments:
+**       psSegments: Frame segments.
+**       iLength:    The amount of bytes to include.
+**
+** Returns:
+**       The calculated CRC32 checksum.
+**------------------------------------------------------------------------------
+*/
+static UINT32 spi_drv_SegmentsCrc32( const ABCC_SYS_SpiSegmentType* psSegments, UINT16 iLength )
+{
+   UINT32 lCrc = 0;
+   UINT16 iSegmentLength;
+
+   while( iLength > 0 )
+   {
+      iSegmentLength = psSegments->iLength;
+      if( iSegmentLength > iLength )
+      {
+         iSegmentLength = iLength;
+      }
+
+      lCrc = CRC_Crc32Update( lCrc, (UINT16*)psSegments->pxData, iSegmentLength );
+      iLength -= iSegmentLength;
+      psSegments++;
+   }
+
+   return( CRC_Crc32Final( lCrc ) );
+}
+#endif
+
+
 /*------------------------------------------------------------------------------
 ** Watchdog timeouthandler
 **------------------------------------------------------------------------------
@@ -647,12 +1131,17 @@ void ABCC_DrvSpiInit( UINT8 bOpmode )
    */
    ABCC_ASSERT_ERR( bOpmode == 1, ABCC_SEV_FATAL, ABCC_EC_INCORRECT_OPERATING_MODE, (UINT32)bOpmode );
 
-   spi_drv_sMosiFrame.iSpiControl = 0;
+   spi_drv_iSpiControl = 0;
    for ( i = 0; i < MAX_PAYLOAD_WORD_LEN; i++ )
    {
-      spi_drv_sMosiFrame.iData[ i ] = 0;
-      spi_drv_sMisoFrame.iData[ i ] = 0;
+      spi_drv_asMosiFrame[ 0 ].iData[ i ] = 0;
+      spi_drv_asMosiFrame[ 1 ].iData[ i ] = 0;
+      spi_drv_asMisoFrame[ 0 ].iData[ i ] = 0;
+      spi_drv_asMisoFrame[ 1 ].iData[ i ] = 0;
    }
+   spi_drv_psMosiFrame = &spi_drv_asMosiFrame[ 0 ];
+   spi_drv_psSentMosiFrame = &spi_drv_asMosiFrame[ 1 ];
+   spi_drv_psMisoFrame = &spi_drv_asMisoFrame[ 0 ];
 
 
    spi_drv_ResetReadFragInfo();
@@ -660,12 +1149,14 @@ void ABCC_DrvSpiInit( UINT8 bOpmode )
    spi_drv_bAnbStatus = 0;
    spi_drv_psReadMessage = 0;
    spi_drv_ResetWriteFragInfo();
-   spi_drv_sMosiFrame.iIntMaskAppStatus = 0;
    spi_drv_bNbrOfCmds = 0;
    spi_drv_eState = SM_SPI_INIT;
    spi_drv_iPdSize = SPI_DEFAULT_PD_LEN;
    spi_drv_iWritePdSize = SPI_DEFAULT_PD_LEN;
    spi_drv_iReadPdSize = SPI_DEFAULT_PD_LEN;
+   spi_drv_iNextWritePdSize = SPI_DEFAULT_PD_LEN;
+   spi_drv_iNextReadPdSize = SPI_DEFAULT_PD_LEN;
+   spi_drv_fNewPdSize = FALSE;
    spi_drv_iPdOffset = NUM_BYTES_2_WORDS( ABCC_CFG_SPI_MSG_FRAG_LEN );
    spi_drv_iCrcOffset = NUM_BYTES_2_WORDS( ABCC_CFG_SPI_MSG_FRAG_LEN ) + SPI_DEFAULT_PD_LEN;
    spi_drv_iSpiFrameSize = SPI_FRAME_SIZE_EXCLUDING_DATA + spi_drv_iCrcOffset;
@@ -673,11 +1164,14 @@ void ABCC_DrvSpiInit( UINT8 bOpmode )
    spi_drv_iMsgLen = 0;
 
    spi_drv_iMsgLen = NUM_BYTES_2_WORDS( ABCC_CFG_SPI_MSG_FRAG_LEN );
-   spi_drv_sMosiFrame.iMsgLen = iTOiLe( spi_drv_iMsgLen );
+#if( ABCC_CFG_SPI_PD_PRIORITY )
+   spi_drv_fPdOnlyFrameSent = FALSE;
+#endif
 
-   spi_drv_sMosiFrame.iPdLen = iTOiLe( spi_drv_iPdSize );
    spi_drv_bNextAppStatus = 0;
    spi_drv_bNextIntMask = 0;
+   spi_drv_bSentAppStatus = 0;
+   spi_drv_bSentIntMask = 0;
    spi_drv_bpRdPd = NULL;
    spi_drv_bAnbCmdCnt = 0;
    xWdTmoHandle = ABCC_TimerCreate( drv_WdTimeoutHandler );
@@ -708,6 +1202,10 @@ BOOL ABCC_DrvSpiWriteMessage( ABP_MsgType* psWriteMsg )
    spi_drv_sWriteFragInfo.psWriteMsg = psWriteMsg;
    ABCC_PORT_ExitCritical();
 
+#if( ABCC_CFG_SPI_PD_PRIORITY )
+   ABCC_CbfSpiSchedEvent( ABCC_SPI_SCHED_MSG_QUEUED );
+#endif
+
    /*
    ** The SPI driver still owns the buffer.
    */
@@ -718,9 +1216,14 @@ BOOL ABCC_DrvSpiWriteMessage( ABP_MsgType* psWriteMsg )
 void ABCC_DrvSpiWriteProcessData( void* pxProcessData )
 {
    (void)pxProcessData;
-   if( spi_drv_eState == SM_SPI_RDY_TO_SEND_MOSI )
+
+   /*
+   ** The process data is written to the MOSI frame being built, which is not
+   ** touched by an ongoing transfer.
+   */
+   if( spi_drv_eState != SM_SPI_INIT )
    {
-      spi_drv_sMosiFrame.iSpiControl |= iSpiCtrlWrPdWalid;
+      spi_drv_iSpiControl |= iSpiCtrlWrPdWalid;
    }
    else
    {
@@ -745,6 +1248,33 @@ BOOL ABCC_DrvSpiIsReadyForCmd( void )
 }
 
 
+BOOL ABCC_DrvSpiIsTransferPending( void )
+{
+   if( spi_drv_eState == SM_SPI_INIT )
+   {
+      return( TRUE );
+   }
+
+   if( spi_drv_eState != SM_SPI_RDY_TO_SEND_MOSI )
+   {
+      return( FALSE );
+   }
+
+   return( spi_drv_fRetransmit ||
+           ( spi_drv_sWriteFragInfo.psWriteMsg != NULL ) ||
+           ( spi_drv_sReadFragInfo.iNumWordsReceived != 0 ) ||
+           ( spi_drv_iSpiControl & iSpiCtrlWrPdWalid ) ||
+           ( spi_drv_bNextAppStatus != spi_drv_bSentAppStatus ) ||
+           ( spi_drv_bNextIntMask != spi_drv_bSentIntMask ) );
+}
+
+
+BOOL ABCC_DrvSpiIsTransferOngoing( void )
+{
+   return( spi_drv_eState == SM_SPI_WAITING_FOR_MISO );
+}
+
+
 void ABCC_DrvSpiSetNbrOfCmds( UINT8 bNbrOfCmds )
 {
    spi_drv_bNbrOfCmds = bNbrOfCmds;
@@ -759,32 +1289,15 @@ void ABCC_DrvSpiSetAppStatus( ABP_AppStatusType eAppStatus )
 
 void ABCC_DrvSpiSetPdSize( const UINT16  iReadPdSize, const UINT16  iWritePdSize)
 {
-   if( spi_drv_eState == SM_SPI_RDY_TO_SEND_MOSI )
-   {
-      /*
-      ** Use the largest PD data size since the PD cannot be fragmented.
-      */
-      spi_drv_iWritePdSize = NUM_BYTES_2_WORDS( iWritePdSize );
-      spi_drv_iReadPdSize = NUM_BYTES_2_WORDS( iReadPdSize );
-
-      spi_drv_iPdSize = spi_drv_iWritePdSize;
-      if( spi_drv_iReadPdSize > spi_drv_iWritePdSize )
-      {
-         spi_drv_iPdSize = spi_drv_iReadPdSize;
-      }
-
-      /*
-      ** Update the CRC position and the total frame size since the process data
-      ** size might have changed.
-      */
-      spi_drv_iCrcOffset = spi_drv_iPdOffset + spi_drv_iPdSize;
-      spi_drv_iSpiFrameSize = SPI_FRAME_SIZE_EXCLUDING_DATA + spi_drv_iCrcOffset;
-      spi_drv_sMosiFrame.iPdLen = iTOiLe( spi_drv_iPdSize );
-   }
-   else
-   {
-      ABCC_ERROR(ABCC_SEV_WARNING, ABCC_EC_SPI_OP_NOT_ALLOWED_DURING_SPI_TRANSACTION,0);
-   }
+   /*
+   ** The next transfer may already be ongoing, since it is started before
+   ** received messages are handled. Its MISO frame is still checked with the
+   ** current layout, so the new sizes are applied when the next MOSI frame is
+   ** prepared.
+   */
+   spi_drv_iNextWritePdSize = NUM_BYTES_2_WORDS( iWritePdSize );
+   spi_drv_iNextReadPdSize = NUM_BYTES_2_WORDS( iReadPdSize );
+   spi_drv_fNewPdSize = TRUE;
 }
 
 static void DrvSpiSetMsgReceiverBuffer( ABP_MsgType* const psReadMsg )
@@ -818,12 +1331,15 @@ UINT8 ABCC_DrvSpiGetAnybusState( void )
 
 void* ABCC_DrvSpiReadProcessData( void )
 {
-   UINT8* pxRdPd = NULL;
+   UINT8* pxRdPd;
 
-   if(  spi_drv_eState == SM_SPI_RDY_TO_SEND_MOSI )
-   {
-      pxRdPd = spi_drv_bpRdPd;
-   }
+   /*
+   ** The process data stays in its MISO buffer until the next MISO frame is
+   ** received, so it may be read during the following transfer. It is
+   ** returned only once.
+   */
+   pxRdPd = spi_drv_bpRdPd;
+   spi_drv_bpRdPd = NULL;
    return pxRdPd;
 }
 
@@ -832,13 +1348,14 @@ ABP_MsgType* ABCC_DrvSpiReadMessage( void )
 {
    ABP_MsgType* psRdMsg = NULL;
 
-   if( spi_drv_eState == SM_SPI_RDY_TO_SEND_MOSI )
+   /*
+   ** The message is assembled in its own buffer, so it may be read during the
+   ** following transfer.
+   */
+   if ( spi_drv_psReadMessage != NULL )
    {
-      if ( spi_drv_psReadMessage != NULL )
-      {
-         psRdMsg = spi_drv_psReadMessage;
-         spi_drv_psReadMessage = NULL;
-     }
+      psRdMsg = spi_drv_psReadMessage;
+      spi_drv_psReadMessage = NULL;
    }
    return psRdMsg;
 }
@@ -851,7 +1368,7 @@ void ABCC_DrvSpiSetIntMask( const UINT16 iIntMask )
 
 void* ABCC_DrvSpiGetWrPdBuffer( void )
 {
-   return &spi_drv_sMosiFrame.iData[ spi_drv_iPdOffset ];
+   return &spi_drv_psMosiFrame->iData[ spi_drv_iPdOffset ];
 }
 
 
@@ -868,7 +1385,11 @@ UINT16 ABCC_DrvSpiGetLedStatus( void )
 
 BOOL ABCC_DrvSpiIsReadyForWrPd( void )
 {
-   if ( spi_drv_eState == SM_SPI_RDY_TO_SEND_MOSI )
+   /*
+   ** Process data may be written also during a transfer, since it goes to the
+   ** MOSI frame being built.
+   */
+   if ( spi_drv_eState != SM_SPI_INIT )
    {
       return TRUE;
    }
@@ -130,6 +130,41 @@ typedef struct ad_Map
 }
 ad_MapType;
 
+/*------------------------------------------------------------------------------
+** Single step of a precomputed process data copy plan. The plan is the map
+** resolved down to plain copies, with the process data offsets already
+** calculated, so the cyclic process data update does not have to walk the ADI
+** entries and structure descriptions. Padding does not produce any step.
+**------------------------------------------------------------------------------
+** psCbfAdiEntry    - If not NULL, this step only invokes the get/set callback
+**                    of this ADI, with bNumElements and bStartIndex.
+** pxValue          - Base pointer of the ADI (or structure element) value.
+** iValueBitOffset  - Bit offset relative pxValue.
+** iPdBitOffset     - Bit offset relative the start of the process data.
+** iNumElem         - Number of elements to copy.
+** bDataType        - Data type according to ABP_<X> types in abp.h
+** bNumElements     - Number of mapped elements, passed to the callback.
+** bStartIndex      - Element start index, passed to the callback.
+** bDirectSize      - Size in octets (1, 2 or 4) of a single octet aligned
+**                    value, which needs no endian swap and is copied straight
+**                    between the ADI and the SPI frame. 0 if CopyValue() is
+**                    needed.
+**------------------------------------------------------------------------------
+*/
+typedef struct ad_CopyStep
+{
+   const AD_AdiEntryType* psCbfAdiEntry;
+   void*                  pxValue;
+   UINT16                 iValueBitOffset;
+   UINT16                 iPdBitOffset;
+   UINT16                 iNumElem;
+   UINT8                  bDataType;
+   UINT8                  bNumElements;
+   UINT8                  bStartIndex;
+   UINT8                  bDirectSize;
+}
+ad_CopyStepType;
+
 /*------------------------------------------------------------------------------
 ** Type with mapping information for a specific direction (read/write).
 **------------------------------------------------------------------------------
@@ -137,14 +172,23 @@ ad_MapType;
 ** iNumMappedAdi       - Number of mapped ADI:s
 ** iMaxNumMappedAdi    - Maximum number of mapped ADI:s.
 ** iPdSize             - Current process data size in octets.
+** pasCopyPlan         - Pointer to the precomputed copy plan.
+** iNumCopySteps       - Number of steps in the copy plan.
+** iMaxNumCopySteps    - Maximum number of steps in the copy plan.
+** fCopyPlanValid      - TRUE if the copy plan reflects the current map. If
+**                       FALSE the map is walked directly (slow path).
 **------------------------------------------------------------------------------
 */
 typedef struct ad_MapInfo
 {
-   ad_MapType*   paiMappedAdiList;
-   UINT16        iNumMappedAdi;
-   UINT16        iMaxNumMappedAdi;
-   UINT16        iPdSize;
+   ad_MapType*      paiMappedAdiList;
+   UINT16           iNumMappedAdi;
+   UINT16           iMaxNumMappedAdi;
+   UINT16           iPdSize;
+   ad_CopyStepType* pasCopyPlan;
+   UINT16           iNumCopySteps;
+   UINT16           iMaxNumCopySteps;
+   BOOL             fCopyPlanValid;
 }
 ad_MapInfoType;
 
@@ -159,9 +203,17 @@ static UINT16  ad_iNumOfADIs;
 static UINT16  ad_iHighestInstanceNumber;
 static ad_MapType ad_PdReadMapping[ AD_MAX_NUM_READ_MAP_ENTRIES ];
 static ad_MapType ad_PdWriteMapping[ AD_MAX_NUM_WRITE_MAP_ENTRIES ];
+static ad_CopyStepType ad_PdReadCopyPlan[ AD_MAX_NUM_READ_COPY_STEPS ];
+static ad_CopyStepType ad_PdWriteCopyPlan[ AD_MAX_NUM_WRITE_COPY_STEPS ];
 static ad_MapInfoType ad_ReadMapInfo;
 static ad_MapInfoType ad_WriteMapInfo;
 
+/*
+** TRUE if the instance number of each ADI is its order number, which lets
+** instances be found without searching the ADI list. Set by AD_Init().
+*/
+static BOOL    ad_fInstancesInOrder = FALSE;
+
 /*******************************************************************************
 ** Private Services
 ********************************************************************************
@@ -233,6 +285,26 @@ while( 0 )
 */
 #define BitToOctetOffset( bitOffset ) ( (bitOffset) >> 3 )
 
+/*------------------------------------------------------------------------------
+** Swaps octets in both 16 bit halves of a 32 bit value. The compiler
+** recognizes the pattern and emits a single REV16 on Cortex-M.
+**------------------------------------------------------------------------------
+*/
+#define EndianSwap16x2( lFoo )                                   \
+   (UINT32)( ( ( (UINT32)(lFoo) & 0x00FF00FFUL ) << 8 ) |        \
+             ( ( (UINT32)(lFoo) >> 8 ) & 0x00FF00FFUL ) )
+
+/*------------------------------------------------------------------------------
+** Largest number of bits CopyBitData() moves at once. Together with a bit
+** offset within one char it still fits into a 32 bit word.
+**------------------------------------------------------------------------------
+*/
+#ifdef ABCC_SYS_16_BIT_CHAR
+#define AD_BIT_CHUNK_SIZE     16
+#else
+#define AD_BIT_CHUNK_SIZE     24
+#endif
+
 /*------------------------------------------------------------------------------
 ** Copies a 16 bit values from a source to a destination. Each value will be
 ** endian swapped. The function support octet alignment.
@@ -255,8 +327,19 @@ static void Copy16WithEndianSwap( void* pxDest, UINT16 iDestOctetOffset,
 {
    UINT16 i;
    UINT16 iConv;
+   UINT32 lConv;
 
-   for( i = 0; i < iNumElem; i++ )
+   /*
+   ** Two values per 32 bit word, both of them swapped at once.
+   */
+   for( i = 0; ( i + 1 ) < iNumElem; i += 2 )
+   {
+      ABCC_PORT_Copy32( &lConv, 0, pxSrc, iSrcOctetOffset + ( i << 1 ) );
+      lConv = EndianSwap16x2( lConv );
+      ABCC_PORT_Copy32( pxDest, iDestOctetOffset + ( i << 1 ), &lConv, 0 );
+   }
+
+   if( i < iNumElem )
    {
       ABCC_PORT_Copy16( &iConv, 0, pxSrc, iSrcOctetOffset + ( i << 1 ) );
       iConv = ABCC_iEndianSwap( iConv );
@@ -475,6 +558,16 @@ static UINT16 GetAdiIndex( UINT16 iInstance )
       return( AD_MAP_PAD_INDEX );
    }
 
+   if( ad_fInstancesInOrder )
+   {
+      if( iInstance <= ad_iNumOfADIs )
+      {
+         iIndex = iInstance - 1;
+      }
+
+      return( iIndex );
+   }
+
    for( i = 0; i < ad_iNumOfADIs; i++ )
    {
       if( ad_asADIEntryList[ i ].iInstance == iInstance )
@@ -487,6 +580,33 @@ static UINT16 GetAdiIndex( UINT16 iInstance )
    return( iIndex );
 }
 
+/*------------------------------------------------------------------------------
+** Check if the instance number of each ADI is its order number, so
+** GetAdiIndex() needs no search. Must be called when the ADI list is set.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None.
+**
+** Returns:
+**    None.
+**------------------------------------------------------------------------------
+*/
+static void CheckInstancesInOrder( void )
+{
+   UINT16 iIndex;
+
+   ad_fInstancesInOrder = TRUE;
+
+   for( iIndex = 0; iIndex < ad_iNumOfADIs; iIndex++ )
+   {
+      if( ad_asADIEntryList[ iIndex ].iInstance != iIndex + 1 )
+      {
+         ad_fInstancesInOrder = FALSE;
+         break;
+      }
+   }
+}
+
 #if( ABCC_CFG_REMAP_SUPPORT_ENABLED )
 /*------------------------------------------------------------------------------
 ** Check if the targeted ADI/element descriptor says that it is PD mappable in
@@ -756,6 +876,13 @@ static void RemapProcessDataCommand( ABP_MsgType* psMsg,
 
       UpdateMapSize( psCurrMap );
 
+      /*
+      ** The new map is taken into use together with the new process data
+      ** sizes, when the response has been sent. Until then fall back to the
+      ** map walk, the plan is rebuilt in AD_RemapDone().
+      */
+      psCurrMap->fCopyPlanValid = FALSE;
+
       ABCC_SetMsgData16(psMsg, psCurrMap->iPdSize, 0);
       ABP_SetMsgResponse( psMsg, 2 );
       ABCC_SendRemapRespMsg( psMsg, ad_ReadMapInfo.iPdSize,
@@ -772,6 +899,9 @@ static void RemapProcessDataCommand( ABP_MsgType* psMsg,
 
 /*------------------------------------------------------------------------------
 ** Copy bit data. Any alignment is allowed.
+** Elements are packed back to back both in the source and in the destination,
+** so all of them are copied as a single run of bits, a 32 bit word at a time.
+** An octet aligned run is copied as whole octets.
 **------------------------------------------------------------------------------
 ** Arguments:
 **    pxDest            - Destination base pointer.
@@ -792,9 +922,10 @@ static UINT16 CopyBitData( void* pxDest,
                            UINT8 bDataType,
                            UINT16 iNumElem )
 {
+   UINT8  bChunkSize;
    UINT8  bCopySize;
-   UINT16 i;
    UINT16 iSetBitSize = 0;
+   UINT16 iBitsLeft;
    UINT32 lBitMask;
    UINT32 lSrc;
    UINT32 lDest;
@@ -822,22 +953,45 @@ static UINT16 CopyBitData( void* pxDest,
       /*
       ** Calculate number of bits to be set.
       */
-      iSetBitSize += ( ( bDataType - ABP_BIT1 ) + 1 );
+      iSetBitSize += ( ( bDataType - ABP_BIT1 ) + 1 ) * iNumElem;
+      iBitsLeft = iSetBitSize;
 
-      for( i = 0; i < iNumElem; i++ )
+#ifndef ABCC_SYS_16_BIT_CHAR
+      if( ( iSrcBitOffset == 0 ) && ( iDestBitOffset == 0 ) )
       {
+         /*
+         ** Both ends are octet aligned, so whole octets need no masking.
+         */
+         ABCC_PORT_CopyOctets( pxDest, iDestOctetOffset, pxSrc, iSrcOctetOffset,
+                               iBitsLeft >> 3 );
+         iSrcOctetOffset += iBitsLeft >> 3;
+         iDestOctetOffset += iBitsLeft >> 3;
+         iBitsLeft &= 7;
+      }
+#endif
+
+      while( iBitsLeft > 0 )
+      {
+         bChunkSize = AD_BIT_CHUNK_SIZE;
+         if( iBitsLeft < bChunkSize )
+         {
+            bChunkSize = (UINT8)iBitsLeft;
+         }
+
          /*
          ** Calculate the number of octets that has to be copied
          ** to include both destination bit offset and bit size.
          */
-         bCopySize = ( iSetBitSize + iDestBitOffset + 7 ) / 8;
+         bCopySize = ( bChunkSize + iDestBitOffset + 7 ) / 8;
 
          /*
          ** Copy parts to be manipulated into local 32 bit variables to
          ** guarantee correct alignment.
          */
-         ABCC_PORT_CopyOctets( &lSrc, 0, pxSrc, iSrcOctetOffset ,
-                               ABP_UINT32_SIZEOF );
+         lSrc = 0;
+         lDest = 0;
+         ABCC_PORT_CopyOctets( &lSrc, 0, pxSrc, iSrcOctetOffset,
+                               ( bChunkSize + iSrcBitOffset + 7 ) / 8 );
          ABCC_PORT_CopyOctets( &lDest, 0, pxDest, iDestOctetOffset, bCopySize );
 
          /*
@@ -849,7 +1003,7 @@ static UINT16 CopyBitData( void* pxDest,
          /*
          ** Calculate bit mask and align it with destination bit offset.
          */
-         lBitMask = ( (UINT32)1 << iSetBitSize ) - 1;
+         lBitMask = ( (UINT32)1 << bChunkSize ) - 1;
          lBitMask <<= iDestBitOffset;
 
          /*
@@ -883,14 +1037,14 @@ static UINT16 CopyBitData( void* pxDest,
          ABCC_PORT_CopyOctets( pxDest, iDestOctetOffset, &lDest, 0, bCopySize );
 
          /*
-         ** Update bit offsets to next bit field.
+         ** Update bit offsets to next chunk.
          */
-         iSrcBitOffset += iSetBitSize;
+         iSrcBitOffset += bChunkSize;
          AddBitsToOctetSize( iSrcOctetOffset, iSrcBitOffset );
-         iDestBitOffset += iSetBitSize;
+         iDestBitOffset += bChunkSize;
          AddBitsToOctetSize( iDestOctetOffset, iDestBitOffset );
+         iBitsLeft -= bChunkSize;
       }
-      iSetBitSize *= iNumElem;
    }
    return( iSetBitSize );
 }
@@ -983,6 +1137,346 @@ static UINT16 CopyValue( void* pxDst,
    return( iBitSetSize );
 }
 
+/*------------------------------------------------------------------------------
+** Calculates the size CopyValue() would copy, without copying anything.
+**------------------------------------------------------------------------------
+** Arguments:
+**    bDataType         - Data type according to ABP_<X> types in abp.h
+**    iNumElem          - Number of elements.
+**
+** Returns:
+**    Size of data in bits.
+**------------------------------------------------------------------------------
+*/
+static UINT16 GetCopySizeInBits( UINT8 bDataType, UINT16 iNumElem )
+{
+   if( ABP_Is_PADx( bDataType ) )
+   {
+      return( ABCC_GetDataTypeSizeInBits( bDataType ) );
+   }
+
+   return( ABCC_GetDataTypeSizeInBits( bDataType ) * iNumElem );
+}
+
+/*------------------------------------------------------------------------------
+** Appends a step to the copy plan.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psMap             - Pointer to mapping information.
+**
+** Returns:
+**    Pointer to the new zeroed step, NULL if the plan is full.
+**------------------------------------------------------------------------------
+*/
+static ad_CopyStepType* AddCopyStep( ad_MapInfoType* psMap )
+{
+   ad_CopyStepType* psStep;
+
+   if( psMap->iNumCopySteps >= psMap->iMaxNumCopySteps )
+   {
+      return( NULL );
+   }
+
+   psStep = &psMap->pasCopyPlan[ psMap->iNumCopySteps++ ];
+   psStep->psCbfAdiEntry = NULL;
+   psStep->pxValue = NULL;
+   psStep->iValueBitOffset = 0;
+   psStep->iPdBitOffset = 0;
+   psStep->iNumElem = 0;
+   psStep->bDataType = ABP_PAD0;
+   psStep->bNumElements = 0;
+   psStep->bStartIndex = 0;
+   psStep->bDirectSize = 0;
+
+   return( psStep );
+}
+
+/*------------------------------------------------------------------------------
+** Checks if a copy step can be done as a single direct load/store.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psStep            - Copy step with all copy fields set.
+**
+** Returns:
+**    Size of the value in octets, 0 if CopyValue() is needed.
+**------------------------------------------------------------------------------
+*/
+static UINT8 GetDirectCopySize( const ad_CopyStepType* psStep )
+{
+#ifdef ABCC_SYS_16_BIT_CHAR
+   (void)psStep;
+   return( 0 );
+#else
+   UINT8 bSize;
+
+   if( Is_BITx_Or_PADx( psStep->bDataType ) ||
+       ( psStep->iNumElem != 1 ) ||
+       ( psStep->iValueBitOffset & 7 ) ||
+       ( psStep->iPdBitOffset & 7 ) )
+   {
+      return( 0 );
+   }
+
+   bSize = ABCC_GetDataTypeSize( psStep->bDataType );
+
+   if( ( bSize > 1 ) && ad_fDoNetworkEndianSwap )
+   {
+      return( 0 );
+   }
+
+   if( ( bSize != 1 ) && ( bSize != 2 ) && ( bSize != 4 ) )
+   {
+      return( 0 );
+   }
+
+   return( bSize );
+#endif
+}
+
+/*------------------------------------------------------------------------------
+** Copies a single octet aligned value. Each size gets its own constant size
+** copy, which the compiler turns into one (unaligned) load and store, instead
+** of a generic memcpy() call.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pxDest            - Destination base pointer.
+**    iDestBitOffset    - Octet aligned bit offset relative destination pointer.
+**    pxSrc             - Source base pointer.
+**    iSrcBitOffset     - Octet aligned bit offset relative source pointer.
+**    bSize             - Size of the value in octets, 1, 2 or 4.
+**
+** Returns:
+**    None.
+**------------------------------------------------------------------------------
+*/
+static void CopyDirect( void* pxDest,
+                        UINT16 iDestBitOffset,
+                        const void* pxSrc,
+                        UINT16 iSrcBitOffset,
+                        UINT8 bSize )
+{
+   UINT8* pbDest = (UINT8*)pxDest + BitToOctetOffset( iDestBitOffset );
+   const UINT8* pbSrc = (const UINT8*)pxSrc + BitToOctetOffset( iSrcBitOffset );
+
+   switch( bSize )
+   {
+   case 1:
+      *pbDest = *pbSrc;
+      break;
+
+   case 2:
+      ABCC_PORT_MemCpy( pbDest, pbSrc, 2 );
+      break;
+
+   case 4:
+      ABCC_PORT_MemCpy( pbDest, pbSrc, 4 );
+      break;
+
+   default:
+      break;
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Resolves the current map into a copy plan. Must be called every time the
+** map is changed. If the plan does not fit, it is marked invalid and the
+** process data update falls back to walking the map.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psMap             - Pointer to mapping information.
+**    fWritePd          - TRUE for the write process data map. The get
+**                        callback is then invoked before the copy, otherwise
+**                        the set callback is invoked after the copy.
+**
+** Returns:
+**    None.
+**------------------------------------------------------------------------------
+*/
+static void BuildCopyPlan( ad_MapInfoType* psMap, BOOL fWritePd )
+{
+   UINT16 iMapIndex;
+   UINT16 iPdBitOffset;
+   const ad_MapType* psMapItem;
+   const AD_AdiEntryType* psAdiEntry;
+   ad_CopyStepType* psStep;
+#if( ABCC_CFG_STRUCT_DATA_TYPE )
+   UINT16 i;
+#endif
+
+   psMap->iNumCopySteps = 0;
+   psMap->fCopyPlanValid = FALSE;
+   iPdBitOffset = 0;
+
+   for( iMapIndex = 0; iMapIndex < psMap->iNumMappedAdi; iMapIndex++ )
+   {
+      psMapItem = &psMap->paiMappedAdiList[ iMapIndex ];
+
+      if( psMapItem->iAdiIndex == AD_MAP_PAD_INDEX )
+      {
+         iPdBitOffset += psMapItem->bNumElements;
+         continue;
+      }
+
+      psAdiEntry = &ad_asADIEntryList[ psMapItem->iAdiIndex ];
+
+#if( ABCC_CFG_ADI_GET_SET_CALLBACK )
+      if( fWritePd && ( psAdiEntry->pnGetAdiValue != NULL ) )
+      {
+         psStep = AddCopyStep( psMap );
+         if( psStep == NULL )
+         {
+            return;
+         }
+         psStep->psCbfAdiEntry = psAdiEntry;
+         psStep->bNumElements = psMapItem->bNumElements;
+         psStep->bStartIndex = psMapItem->bStartIndex;
+      }
+#endif
+
+#if( ABCC_CFG_STRUCT_DATA_TYPE )
+      if( psAdiEntry->psStruct != NULL )
+      {
+         for( i = psMapItem->bStartIndex;
+              i < psMapItem->bNumElements + psMapItem->bStartIndex; i++ )
+         {
+            if( !ABP_Is_PADx( psAdiEntry->psStruct[ i ].bDataType ) )
+            {
+               psStep = AddCopyStep( psMap );
+               if( psStep == NULL )
+               {
+                  return;
+               }
+               psStep->pxValue = psAdiEntry->psStruct[ i ].uData.sVOID.pxValuePtr;
+               psStep->iValueBitOffset = psAdiEntry->psStruct[ i ].bBitOffset;
+               psStep->iPdBitOffset = iPdBitOffset;
+               psStep->iNumElem = psAdiEntry->psStruct[ i ].iNumSubElem;
+               psStep->bDataType = psAdiEntry->psStruct[ i ].bDataType;
+               psStep->bDirectSize = GetDirectCopySize( psStep );
+            }
+
+            iPdBitOffset += GetCopySizeInBits( psAdiEntry->psStruct[ i ].bDataType,
+                                               psAdiEntry->psStruct[ i ].iNumSubElem );
+         }
+      }
+      else
+#endif
+      {
+         if( !ABP_Is_PADx( psAdiEntry->bDataType ) )
+         {
+            psStep = AddCopyStep( psMap );
+            if( psStep == NULL )
+            {
+               return;
+            }
+            psStep->pxValue = psAdiEntry->uData.sVOID.pxValuePtr;
+            psStep->iValueBitOffset = CalcStartindexBitOffset( psAdiEntry->bDataType,
+                                                               psMapItem->bStartIndex );
+            psStep->iPdBitOffset = iPdBitOffset;
+            psStep->iNumElem = psMapItem->bNumElements;
+            psStep->bDataType = psAdiEntry->bDataType;
+            psStep->bDirectSize = GetDirectCopySize( psStep );
+         }
+
+         iPdBitOffset += GetCopySizeInBits( psAdiEntry->bDataType,
+                                            psMapItem->bNumElements );
+      }
+
+#if( ABCC_CFG_ADI_GET_SET_CALLBACK )
+      if( !fWritePd && ( psAdiEntry->pnSetAdiValue != NULL ) )
+      {
+         psStep = AddCopyStep( psMap );
+         if( psStep == NULL )
+         {
+            return;
+         }
+         psStep->psCbfAdiEntry = psAdiEntry;
+         psStep->bNumElements = psMapItem->bNumElements;
+         psStep->bStartIndex = psMapItem->bStartIndex;
+      }
+#endif
+   }
+
+   psMap->fCopyPlanValid = TRUE;
+}
+
+/*------------------------------------------------------------------------------
+** Executes the copy plan between the process data buffer and the ADI values.
+** With the SPI driver the buffer is the process data area of the MOSI frame
+** (write) or MISO frame (read) itself, so this is the only copy of the
+** process data done by the CPU.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psMap             - Pointer to mapping information with a valid plan.
+**    pxPdDataBuf       - Pointer to the process data buffer.
+**    fWritePd          - TRUE to copy ADI values into write process data,
+**                        FALSE to copy read process data into ADI values.
+**
+** Returns:
+**    None.
+**------------------------------------------------------------------------------
+*/
+static void RunCopyPlan( const ad_MapInfoType* psMap,
+                         void* pxPdDataBuf,
+                         BOOL fWritePd )
+{
+   UINT16 i;
+   const ad_CopyStepType* psStep = psMap->pasCopyPlan;
+
+   for( i = 0; i < psMap->iNumCopySteps; i++, psStep++ )
+   {
+      if( psStep->psCbfAdiEntry != NULL )
+      {
+#if( ABCC_CFG_ADI_GET_SET_CALLBACK )
+         if( fWritePd )
+         {
+            psStep->psCbfAdiEntry->pnGetAdiValue( psStep->psCbfAdiEntry,
+                                                  psStep->bNumElements,
+                                                  psStep->bStartIndex );
+         }
+         else
+         {
+            psStep->psCbfAdiEntry->pnSetAdiValue( psStep->psCbfAdiEntry,
+                                                  psStep->bNumElements,
+                                                  psStep->bStartIndex );
+         }
+#endif
+      }
+      else if( psStep->bDirectSize != 0 )
+      {
+         if( fWritePd )
+         {
+            CopyDirect( pxPdDataBuf, psStep->iPdBitOffset,
+                        psStep->pxValue, psStep->iValueBitOffset,
+                        psStep->bDirectSize );
+         }
+         else
+         {
+            CopyDirect( psStep->pxValue, psStep->iValueBitOffset,
+                        pxPdDataBuf, psStep->iPdBitOffset,
+                        psStep->bDirectSize );
+         }
+      }
+      else if( fWritePd )
+      {
+         (void)CopyValue( pxPdDataBuf,
+                          psStep->iPdBitOffset,
+                          psStep->pxValue,
+                          psStep->iValueBitOffset,
+                          psStep->bDataType,
+                          psStep->iNumElem );
+      }
+      else
+      {
+         (void)CopyValue( psStep->pxValue,
+                          psStep->iValueBitOffset,
+                          pxPdDataBuf,
+                          psStep->iPdBitOffset,
+                          psStep->bDataType,
+                          psStep->iNumElem );
+      }
+   }
+}
+
 #if( AD_IA_MIN_MAX_DEFAULT_ENABLE )
 /*------------------------------------------------------------------------------
 ** Get theoretical min and max properties for a data type.
@@ -1746,15 +2240,25 @@ EXTFUNC APPL_ErrCodeType AD_Init( const AD_AdiEntryType* psAdiEntry,
    ad_iNumOfADIs =  iNumAdi;
    ad_iHighestInstanceNumber = 0;
 
+   CheckInstancesInOrder();
+
    ad_ReadMapInfo.paiMappedAdiList = ad_PdReadMapping;
    ad_ReadMapInfo.iPdSize = 0;
    ad_ReadMapInfo.iNumMappedAdi = 0;
    ad_ReadMapInfo.iMaxNumMappedAdi = AD_MAX_NUM_READ_MAP_ENTRIES;
+   ad_ReadMapInfo.pasCopyPlan = ad_PdReadCopyPlan;
+   ad_ReadMapInfo.iNumCopySteps = 0;
+   ad_ReadMapInfo.iMaxNumCopySteps = AD_MAX_NUM_READ_COPY_STEPS;
+   ad_ReadMapInfo.fCopyPlanValid = FALSE;
 
    ad_WriteMapInfo.paiMappedAdiList = ad_PdWriteMapping;
    ad_WriteMapInfo.iPdSize = 0;
    ad_WriteMapInfo.iNumMappedAdi = 0;
    ad_WriteMapInfo.iMaxNumMappedAdi = AD_MAX_NUM_WRITE_MAP_ENTRIES;
+   ad_WriteMapInfo.pasCopyPlan = ad_PdWriteCopyPlan;
+   ad_WriteMapInfo.iNumCopySteps = 0;
+   ad_WriteMapInfo.iMaxNumCopySteps = AD_MAX_NUM_WRITE_COPY_STEPS;
+   ad_WriteMapInfo.fCopyPlanValid = FALSE;
 
    if( ad_asDefaultMap != NULL )
    {
@@ -1840,6 +2344,9 @@ EXTFUNC APPL_ErrCodeType AD_Init( const AD_AdiEntryType* psAdiEntry,
       return( APPL_AD_PD_WRITE_SIZE_ERR );
    }
 
+   BuildCopyPlan( &ad_WriteMapInfo, TRUE );
+   BuildCopyPlan( &ad_ReadMapInfo, FALSE );
+
    for( iAdiIndex = 0; iAdiIndex < ad_iNumOfADIs; iAdiIndex++ )
    {
       if( ad_asADIEntryList[ iAdiIndex ].iInstance > ad_iHighestInstanceNumber )
@@ -2506,6 +3013,12 @@ void AD_UpdatePdReadData( void* pxPdDataBuf )
    UINT16 iRdPdBitOffset;
    const ad_MapType* AD_paiPdReadMap = ad_ReadMapInfo.paiMappedAdiList;
 
+   if( ad_ReadMapInfo.fCopyPlanValid )
+   {
+      RunCopyPlan( &ad_ReadMapInfo, pxPdDataBuf, FALSE );
+      return;
+   }
+
    iRdPdBitOffset = 0;
 
    if( AD_paiPdReadMap )
@@ -2545,6 +3058,12 @@ BOOL AD_UpdatePdWriteData( void* pxPdDataBuf )
    UINT16 iWrPdBitOffset;
    const ad_MapType* paiPdWriteMap = ad_WriteMapInfo.paiMappedAdiList;
 
+   if( ad_WriteMapInfo.fCopyPlanValid )
+   {
+      RunCopyPlan( &ad_WriteMapInfo, pxPdDataBuf, TRUE );
+      return( TRUE );
+   }
+
    if( paiPdWriteMap )
    {
       iWrPdBitOffset = 0;
@@ -2590,6 +3109,12 @@ UINT16 AD_AdiMappingReq( const AD_AdiEntryType** ppsAdiEntry,
    ad_fDoNetworkEndianSwap = ( eNetFormat == NET_LITTLEENDIAN ) ? FALSE : TRUE;
 #endif
 
+   /*
+   ** Direct copies depend on the network endian, so resolve the maps again.
+   */
+   BuildCopyPlan( &ad_WriteMapInfo, TRUE );
+   BuildCopyPlan( &ad_ReadMapInfo, FALSE );
+
    *ppsAdiEntry = ad_asADIEntryList;
    *ppsDefaultMap = ad_asDefaultMap;
 
@@ -2598,6 +3123,12 @@ UINT16 AD_AdiMappingReq( const AD_AdiEntryType** ppsAdiEntry,
 
 void AD_RemapDone( void )
 {
+   /*
+   ** New map and process data sizes are active now, resolve the maps again.
+   */
+   BuildCopyPlan( &ad_WriteMapInfo, TRUE );
+   BuildCopyPlan( &ad_ReadMapInfo, FALSE );
+
    /*
    ** This Write Process Data update is to ensure that the write process data
    ** is updated with the right content.
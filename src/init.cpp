@@ -2,6 +2,7 @@
 #include "tivaware/inc/hw_memmap.h"
 #include "tivaware/inc/hw_types.h"
 #include "tivaware/inc/hw_nvic.h"
+#include "tivaware/inc/hw_ints.h"
 #include "tivaware/driverlib/sysctl.h"
 #include "tivaware/driverlib/interrupt.h"
 #include "tivaware/driverlib/gpio.h"
@@ -61,6 +62,10 @@ void initIO()
 	// enable GPIO for UART0 module
 	MAP_GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
 
+	// UARTstdio is buffered, characters are sent from the UART interrupt.
+	//  Vector table is in RAM, so the handler has to be registered
+	IntRegister(INT_UART0, UARTStdioIntHandler);
+
 	constexpr auto IOBaudRate = 115200;
 	UARTStdioConfig(0, IOBaudRate, ClockHz);
 
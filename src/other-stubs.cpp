@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include "tivaware/driverlib/interrupt.h"
 #include "tivaware/utils/uartstdio.h"
 
 extern "C"
@@ -39,6 +40,14 @@ void __assert_func(const char* filename, int lineno,
 	UARTprintf("Assertion failed: %s, file %s, line %d, function: %s\n",
 		expression, filename, lineno, func);
 
+	// UARTstdio is buffered and nothing will be serviced anymore, so push
+	//  the pending logs out by hand, polling the UART interrupt handler
+	IntMasterDisable();
+	while(UARTTxBytesFree() != UART_TX_BUFFER_SIZE)
+	{
+		UARTStdioIntHandler();
+	}
+
 	abort();
 }
 